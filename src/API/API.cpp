@@ -2,6 +2,24 @@
 #include <Utils/Encoding.h>
 #include <PrismaUI/ViewManager.h>
 #include <PrismaUI/Communication.h>
+#include <PrismaUI/MemoryGovernor.h>
+#include <PrismaUI/CachingFileSystem.h>
+#include <PrismaUI/Listeners.h>
+#include <PrismaUI/Core.h>
+#include <PrismaUI/ScriptScheduler.h>
+
+static std::function<void(PrismaUI::Core::PrismaViewId)> WrapDomReadyCallback(PRISMA_UI_API::OnDomReadyCallback onDomReadyCallback)
+{
+    if (!onDomReadyCallback) {
+        return nullptr;
+    }
+
+    return [onDomReadyCallback](PrismaUI::Core::PrismaViewId viewId) {
+        SKSE::GetTaskInterface()->AddTask([callback = onDomReadyCallback, id = viewId]() {
+            callback(id);
+        });
+    };
+}
 
 PrismaView PluginAPI::PrismaUIInterface::CreateView(const char* htmlPath, PRISMA_UI_API::OnDomReadyCallback onDomReadyCallback) noexcept
 {
@@ -9,16 +27,7 @@ PrismaView PluginAPI::PrismaUIInterface::CreateView(const char* htmlPath, PRISMA
         return 0;
     }
 
-    std::function<void(PrismaUI::Core::PrismaViewId)> domReadyWrapper = nullptr;
-    if (onDomReadyCallback) {
-        domReadyWrapper = [onDomReadyCallback](PrismaUI::Core::PrismaViewId viewId) {
-            SKSE::GetTaskInterface()->AddTask([callback = onDomReadyCallback, id = viewId]() {
-                callback(id);
-            });
-        };
-    }
-
-    return PrismaUI::ViewManager::Create(htmlPath, domReadyWrapper);
+    return PrismaUI::ViewManager::Create(htmlPath, WrapDomReadyCallback(onDomReadyCallback));
 }
 
 void PluginAPI::PrismaUIInterface::Invoke(PrismaView view, const char* script, PRISMA_UI_API::JSCallback callback) noexcept
@@ -179,3 +188,138 @@ int PluginAPI::PrismaUIInterface::GetOrder(PrismaView view) noexcept
 	}
 	return PrismaUI::ViewManager::GetOrder(view);
 }
+
+PRISMA_UI_API::MemoryStats PluginAPI::PrismaUIInterface::GetMemoryStats() noexcept
+{
+    auto stats = PrismaUI::MemoryGovernor::GetStats();
+    return { stats.cpuBytes, stats.gpuBytes, stats.budgetBytes, stats.viewCount, stats.evictedViewCount, stats.hibernatedViewCount, stats.purgeCount };
+}
+
+PRISMA_UI_API::ViewMemoryStats PluginAPI::PrismaUIInterface::GetViewMemoryStats(PrismaView view) noexcept
+{
+    if (!view) {
+        return { 0, 0, false };
+    }
+    auto usage = PrismaUI::MemoryGovernor::GetViewUsage(view);
+    return { usage.cpuBytes, usage.gpuBytes, usage.evicted };
+}
+
+void PluginAPI::PrismaUIInterface::Hibernate(PrismaView view) noexcept
+{
+    if (!view) {
+        return;
+    }
+    return PrismaUI::ViewManager::Hibernate(view);
+}
+
+bool PluginAPI::PrismaUIInterface::IsHibernated(PrismaView view) noexcept
+{
+    if (!view) {
+        return false;
+    }
+    return PrismaUI::ViewManager::IsHibernated(view);
+}
+
+PrismaView PluginAPI::PrismaUIInterface::PrewarmView(const char* htmlPath, PRISMA_UI_API::OnDomReadyCallback onDomReadyCallback) noexcept
+{
+    if (!htmlPath) {
+        return 0;
+    }
+
+    try {
+        return PrismaUI::ViewManager::Prewarm(htmlPath, WrapDomReadyCallback(onDomReadyCallback));
+    }
+    catch (const std::exception& e) {
+        logger::error("PrewarmView: {}", e.what());
+        return 0;
+    }
+}
+
+void PluginAPI::PrismaUIInterface::SetCreationPriority(PrismaView view, int priority) noexcept
+{
+    if (!view) {
+        return;
+    }
+    PrismaUI::ViewManager::SetCreationPriority(view, priority);
+}
+
+PRISMA_UI_API::AssetCacheStats PluginAPI::PrismaUIInterface::GetAssetCacheStats() noexcept
+{
+    auto cache = PrismaUI::CachingFileSystem::Get();
+    if (!cache) {
+        return {};
+    }
+    auto stats = cache->GetStats();
+    return { stats.hits, stats.misses, stats.bytesServedFromCache, stats.bytesReadFromDisk,
+        stats.cachedBytes, stats.capacityBytes, stats.entryCount, stats.dedupedEntryCount };
+}
+
+PrismaView PluginAPI::PrismaUIInterface::CreateViewInSession(const char* htmlPath, const char* sessionName, bool persistent, PRISMA_UI_API::OnDomReadyCallback onDomReadyCallback) noexcept
+{
+    if (!htmlPath || !sessionName) {
+        return 0;
+    }
+
+    try {
+        return PrismaUI::ViewManager::CreateInSession(htmlPath, sessionName, persistent, WrapDomReadyCallback(onDomReadyCallback));
+    }
+    catch (const std::exception& e) {
+        logger::error("CreateViewInSession: {}", e.what());
+        return 0;
+    }
+}
+
+PRISMA_UI_API::UltralightLogStats PluginAPI::PrismaUIInterface::GetUltralightLogStats() noexcept
+{
+    using PrismaUI::Listeners::UltralightLogCategory;
+
+    auto stats = PrismaUI::Listeners::GetUltralightLogStats();
+    auto count = [&stats](UltralightLogCategory category) {
+        return stats.categoryCounts[static_cast<size_t>(category)];
+    };
+    return { stats.errors, stats.warnings, count(UltralightLogCategory::Resource), count(UltralightLogCategory::Memory),
+        count(UltralightLogCategory::Font), count(UltralightLogCategory::Graphics), count(UltralightLogCategory::Script),
+        count(UltralightLogCategory::Other) };
+}
+
+PRISMA_UI_API::UIQueueStats PluginAPI::PrismaUIInterface::GetUIQueueStats() noexcept
+{
+    auto lane = [](TaskPriority priority) -> PRISMA_UI_API::UIQueueLaneStats {
+        auto stats = PrismaUI::Core::ultralightThread.get_lane_stats(priority);
+        double averageWaitMs = stats.executed > 0 ? stats.totalWaitMs / static_cast<double>(stats.executed) : 0.0;
+        return { stats.depth, stats.peakDepth, stats.executed, stats.promoted, stats.maxWaitMs, averageWaitMs };
+    };
+    return { lane(TaskPriority::Input), lane(TaskPriority::Render), lane(TaskPriority::Interop), lane(TaskPriority::Background) };
+}
+
+PRISMA_UI_API::ScriptQueueStats PluginAPI::PrismaUIInterface::GetScriptQueueStats(PrismaView view) noexcept
+{
+    auto stats = PrismaUI::ScriptScheduler::GetStats(view);
+    return { stats.queueDepth, stats.executed, stats.deferred };
+}
+
+void PluginAPI::PrismaUIInterface::DestroyWithCallback(PrismaView view, PRISMA_UI_API::OnDestroyedCallback onDestroyed) noexcept
+{
+    if (!view) {
+        return;
+    }
+
+    std::function<void(PrismaUI::Core::PrismaViewId)> callbackWrapper = nullptr;
+
+    if (onDestroyed) {
+        callbackWrapper = [onDestroyed](PrismaUI::Core::PrismaViewId viewId) {
+            SKSE::GetTaskInterface()->AddTask([callback = onDestroyed, id = viewId]() {
+                callback(id);
+            });
+        };
+    }
+
+    return PrismaUI::ViewManager::Destroy(view, callbackWrapper);
+}
+
+PRISMA_UI_API::FrameBufferArenaStats PluginAPI::PrismaUIInterface::GetFrameBufferArenaStats() noexcept
+{
+    auto stats = BufferArena::GetStats();
+    return { stats.blocksInUse, stats.bytesInUse, stats.blocksCached, stats.bytesCached,
+        stats.allocations, stats.reuses, stats.allocationFailures, stats.largePageBlocks, stats.largePagesEnabled };
+}
@@ -5,9 +5,10 @@
 class PluginAPI
 {
 	using InterfaceVersion1 = PRISMA_UI_API::IVPrismaUI1;
+	using InterfaceVersion2 = PRISMA_UI_API::IVPrismaUI2;
 
 public:
-	class PrismaUIInterface : public InterfaceVersion1
+	class PrismaUIInterface : public InterfaceVersion2
 	{
 	private:
 		PrismaUIInterface() noexcept {};
@@ -39,6 +40,22 @@ public:
 		virtual void SetOrder(PrismaView view, int order) noexcept override;
 		virtual int GetOrder(PrismaView view) noexcept override;
 
+		// InterfaceVersion2
+
+		virtual PRISMA_UI_API::MemoryStats GetMemoryStats() noexcept override;
+		virtual PRISMA_UI_API::ViewMemoryStats GetViewMemoryStats(PrismaView view) noexcept override;
+		virtual void Hibernate(PrismaView view) noexcept override;
+		virtual bool IsHibernated(PrismaView view) noexcept override;
+		virtual PrismaView PrewarmView(const char* htmlPath, PRISMA_UI_API::OnDomReadyCallback onDomReadyCallback = nullptr) noexcept override;
+		virtual void SetCreationPriority(PrismaView view, int priority) noexcept override;
+		virtual PRISMA_UI_API::AssetCacheStats GetAssetCacheStats() noexcept override;
+		virtual PrismaView CreateViewInSession(const char* htmlPath, const char* sessionName, bool persistent = true, PRISMA_UI_API::OnDomReadyCallback onDomReadyCallback = nullptr) noexcept override;
+		virtual PRISMA_UI_API::UltralightLogStats GetUltralightLogStats() noexcept override;
+		virtual PRISMA_UI_API::UIQueueStats GetUIQueueStats() noexcept override;
+		virtual PRISMA_UI_API::ScriptQueueStats GetScriptQueueStats(PrismaView view) noexcept override;
+		virtual void DestroyWithCallback(PrismaView view, PRISMA_UI_API::OnDestroyedCallback onDestroyed) noexcept override;
+		virtual PRISMA_UI_API::FrameBufferArenaStats GetFrameBufferArenaStats() noexcept override;
+
 	private:
 		unsigned long apiTID = 0;
 	};
@@ -0,0 +1,232 @@
+﻿#include "AssetPrefetcher.h"
+#include "Core.h"
+#include "CachingFileSystem.h"
+#include "Settings.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace PrismaUI::AssetPrefetcher {
+	using namespace Core;
+
+	static std::string ToLower(std::string_view text) {
+		std::string result(text);
+		for (auto& c : result) {
+			if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+		}
+		return result;
+	}
+
+	static bool StartsWith(std::string_view text, std::string_view prefix) {
+		return text.size() >= prefix.size() && ToLower(text.substr(0, prefix.size())) == prefix;
+	}
+
+	static bool IsAttributeNameChar(char c) {
+		return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '_' || c == ':';
+	}
+
+	// Finds attribute in a lowercased tag body and returns its value from the original text.
+	static std::string_view FindAttribute(std::string_view tag, const std::string& lowerTag, std::string_view attribute) {
+		size_t pos = 0;
+		while ((pos = lowerTag.find(attribute, pos)) != std::string::npos) {
+			size_t end = pos + attribute.size();
+			bool standalone = (pos == 0 || !IsAttributeNameChar(lowerTag[pos - 1]));
+			pos = end;
+			if (!standalone) continue;
+
+			while (end < tag.size() && isspace(static_cast<unsigned char>(tag[end]))) end++;
+			if (end >= tag.size() || tag[end] != '=') continue;
+			end++;
+			while (end < tag.size() && isspace(static_cast<unsigned char>(tag[end]))) end++;
+			if (end >= tag.size()) return {};
+
+			char quote = tag[end];
+			if (quote == '"' || quote == '\'') {
+				size_t close = tag.find(quote, end + 1);
+				if (close == std::string_view::npos) return {};
+				return tag.substr(end + 1, close - end - 1);
+			}
+
+			size_t close = end;
+			while (close < tag.size() && !isspace(static_cast<unsigned char>(tag[close])) && tag[close] != '>') close++;
+			return tag.substr(end, close - end);
+		}
+		return {};
+	}
+
+	std::vector<std::string> FindAssetReferences(std::string_view html) {
+		std::vector<std::string> references;
+
+		size_t pos = 0;
+		while ((pos = html.find('<', pos)) != std::string_view::npos && references.size() < MAX_ASSETS_PER_VIEW) {
+			if (html.compare(pos, 4, "<!--") == 0) {
+				size_t commentEnd = html.find("-->", pos + 4);
+				if (commentEnd == std::string_view::npos) break;
+				pos = commentEnd + 3;
+				continue;
+			}
+
+			size_t nameEnd = pos + 1;
+			while (nameEnd < html.size() && isalpha(static_cast<unsigned char>(html[nameEnd]))) nameEnd++;
+			std::string name = ToLower(html.substr(pos + 1, nameEnd - pos - 1));
+
+			size_t tagEnd = html.find('>', nameEnd);
+			if (tagEnd == std::string_view::npos) break;
+
+			const char* attribute = nullptr;
+			if (name == "script" || name == "img") {
+				attribute = "src";
+			}
+			else if (name == "link") {
+				attribute = "href";
+			}
+
+			if (attribute) {
+				std::string_view tag = html.substr(nameEnd, tagEnd - nameEnd);
+				std::string_view value = FindAttribute(tag, ToLower(tag), attribute);
+				if (!value.empty()) {
+					references.emplace_back(value);
+				}
+			}
+
+			// Inline script bodies can contain '<' that is not markup.
+			if (name == "script") {
+				size_t scriptEnd = ToLower(html.substr(tagEnd)).find("</script");
+				pos = scriptEnd == std::string::npos ? html.size() : tagEnd + scriptEnd;
+			}
+			else {
+				pos = tagEnd + 1;
+			}
+		}
+
+		return references;
+	}
+
+	std::string PercentDecode(std::string_view text) {
+		std::string result;
+		result.reserve(text.size());
+		for (size_t i = 0; i < text.size(); i++) {
+			if (text[i] == '%' && i + 2 < text.size() && isxdigit(static_cast<unsigned char>(text[i + 1])) && isxdigit(static_cast<unsigned char>(text[i + 2]))) {
+				result.push_back(static_cast<char>(std::stoi(std::string(text.substr(i + 1, 2)), nullptr, 16)));
+				i += 2;
+			}
+			else {
+				result.push_back(text[i]);
+			}
+		}
+		return result;
+	}
+
+	std::string ResolveReference(const std::string& documentPath, std::string_view reference) {
+		while (!reference.empty() && isspace(static_cast<unsigned char>(reference.front()))) reference.remove_prefix(1);
+		while (!reference.empty() && isspace(static_cast<unsigned char>(reference.back()))) reference.remove_suffix(1);
+
+		size_t suffix = reference.find_first_of("?#");
+		if (suffix != std::string_view::npos) reference = reference.substr(0, suffix);
+		if (reference.empty() || reference.starts_with("//")) return {};
+
+		std::string combined;
+		if (StartsWith(reference, "file:///")) {
+			combined = PercentDecode(reference.substr(8));
+		}
+		else if (reference.find(':') != std::string_view::npos) {
+			// http:, https:, data:, blob:, javascript: ...
+			return {};
+		}
+		else if (reference.front() == '/') {
+			combined = PercentDecode(reference.substr(1));
+		}
+		else {
+			size_t slash = documentPath.find_last_of('/');
+			combined = (slash == std::string::npos ? std::string() : documentPath.substr(0, slash + 1)) + PercentDecode(reference);
+		}
+
+		std::vector<std::string> segments;
+		size_t start = 0;
+		while (start <= combined.size()) {
+			size_t end = combined.find_first_of("/\\", start);
+			if (end == std::string::npos) end = combined.size();
+			std::string segment = combined.substr(start, end - start);
+			if (segment == "..") {
+				if (segments.empty()) return {};
+				segments.pop_back();
+			}
+			else if (!segment.empty() && segment != ".") {
+				segments.push_back(std::move(segment));
+			}
+			start = end + 1;
+		}
+
+		std::string resolved;
+		for (const auto& segment : segments) {
+			if (!resolved.empty()) resolved.push_back('/');
+			resolved += segment;
+		}
+		return resolved;
+	}
+
+	static void PrefetchOnIoThread(const std::shared_ptr<PrismaView>& viewData, const std::string& documentPath) {
+		auto cache = CachingFileSystem::Get();
+		if (!cache) return;
+
+		auto start = std::chrono::steady_clock::now();
+
+		RefPtr<Buffer> html = cache->OpenFile(String(documentPath.c_str()));
+		if (!html) {
+			logger::debug("AssetPrefetcher: View [{}] document {} not found, nothing to prefetch.", viewData->id, documentPath);
+			return;
+		}
+
+		std::string_view htmlText(static_cast<const char*>(html->data()), std::min(html->size(), MAX_HTML_BYTES_TO_SCAN));
+		auto references = FindAssetReferences(htmlText);
+
+		std::unordered_set<std::string> seen;
+		size_t warmed = 0;
+		uint64_t bytes = html->size();
+		for (const auto& reference : references) {
+			std::string assetPath = ResolveReference(documentPath, reference);
+			if (assetPath.empty() || !seen.insert(assetPath).second) continue;
+
+			RefPtr<Buffer> asset = cache->OpenFile(String(assetPath.c_str()));
+			if (asset) {
+				warmed++;
+				bytes += asset->size();
+			}
+		}
+
+		double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		logger::debug("AssetPrefetcher: View [{}] prefetched {} of {} asset(s), {} KB in {:.2f} ms.",
+			viewData->id, warmed, seen.size(), bytes / 1024, elapsedMs);
+	}
+
+	bool IsEnabled() {
+		return ioThread && CachingFileSystem::Get() && Settings::Get().fileSystem.prefetchAssets;
+	}
+
+	void Prefetch(const std::shared_ptr<PrismaView>& viewData, const std::string& htmlPath) {
+		if (!viewData) return;
+		if (!IsEnabled()) {
+			viewData->prefetchPending = false;
+			return;
+		}
+
+		std::string documentPath = "Data/PrismaUI/views/" + htmlPath;
+		std::replace(documentPath.begin(), documentPath.end(), '\\', '/');
+
+		try {
+			ioThread->submit([viewData, documentPath]() {
+				try {
+					PrefetchOnIoThread(viewData, documentPath);
+				}
+				catch (const std::exception& e) {
+					logger::warn("AssetPrefetcher: View [{}] prefetch failed: {}", viewData->id, e.what());
+				}
+				viewData->prefetchPending = false;
+				});
+		}
+		catch (const std::exception& e) {
+			logger::warn("AssetPrefetcher: Cannot queue prefetch for View [{}]: {}", viewData->id, e.what());
+			viewData->prefetchPending = false;
+		}
+	}
+}
@@ -0,0 +1,36 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace PrismaUI::Core {
+	typedef uint64_t PrismaViewId;
+	struct PrismaView;
+}
+
+namespace PrismaUI::AssetPrefetcher {
+	// Upper bounds so a huge or generated page cannot keep the I/O thread busy for long.
+	constexpr size_t MAX_HTML_BYTES_TO_SCAN = 4 * 1024 * 1024;
+	constexpr size_t MAX_ASSETS_PER_VIEW = 256;
+
+	// Whether Prefetch can run: asset prefetching is enabled and the I/O thread and cache exist.
+	bool IsEnabled();
+
+	// Queues reading the view's HTML and the scripts, stylesheets and images it references on the
+	// I/O thread, warming the asset cache. The caller sets viewData->prefetchPending before the view
+	// is published, so the UI thread cannot create it first; Prefetch clears it when done.
+	void Prefetch(const std::shared_ptr<Core::PrismaView>& viewData, const std::string& htmlPath);
+
+	// Returns the src/href values of <script>, <link> and <img> tags in html.
+	std::vector<std::string> FindAssetReferences(std::string_view html);
+
+	// Decodes %XX escapes, e.g. "My%20Mod" to "My Mod". Malformed escapes are kept as they are.
+	std::string PercentDecode(std::string_view text);
+
+	// Resolves reference relative to the directory of documentPath. Returns an empty string
+	// for anything that is not a local file (http, data: URIs, fragments...).
+	std::string ResolveReference(const std::string& documentPath, std::string_view reference);
+}
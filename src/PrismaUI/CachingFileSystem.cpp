@@ -0,0 +1,189 @@
+﻿#include "CachingFileSystem.h"
+#include "PackFormat.h"
+
+#include <Utils/Hash.h>
+
+#include <cstring>
+
+namespace PrismaUI::CachingFileSystem {
+	static CachingFileSystem* instance = nullptr;
+
+	// Returns the Data-relative key of file_path, or an empty string for paths outside the Data folder.
+	static std::string ToKey(const String& file_path) {
+		const auto& utf8 = file_path.utf8();
+		std::string_view path(utf8.data(), utf8.length());
+		size_t start = path.find_first_not_of("/\\");
+		if (start == std::string_view::npos || path.size() - start < 5 || _strnicmp(path.data() + start, "data", 4) != 0 ||
+			(path[start + 4] != '/' && path[start + 4] != '\\')) {
+			return {};
+		}
+		return PackFormat::NormalizePath(path);
+	}
+
+	CachingFileSystem::CachingFileSystem(FileSystem* inner, std::filesystem::path baseDirectory, uint64_t capacityBytes)
+		: inner_(inner), baseDirectory_(std::move(baseDirectory)), capacityBytes_(capacityBytes) {
+		stats_.capacityBytes = capacityBytes;
+	}
+
+	std::filesystem::path CachingFileSystem::Resolve(const std::string& key) const {
+		// Keys are relative to the Data folder, see PackFormat::NormalizePath.
+		return baseDirectory_ / "Data" / std::filesystem::u8path(key);
+	}
+
+	bool CachingFileSystem::FileExists(const String& file_path) {
+		return inner_->FileExists(file_path);
+	}
+
+	String CachingFileSystem::GetFileMimeType(const String& file_path) {
+		return inner_->GetFileMimeType(file_path);
+	}
+
+	String CachingFileSystem::GetFileCharset(const String& file_path) {
+		return inner_->GetFileCharset(file_path);
+	}
+
+	RefPtr<Buffer> CachingFileSystem::OpenFile(const String& file_path) {
+		std::string key = ToKey(file_path);
+		if (key.empty()) {
+			return inner_->OpenFile(file_path);
+		}
+
+		std::error_code ec;
+		auto resolved = Resolve(key);
+		auto lastWriteTime = std::filesystem::last_write_time(resolved, ec);
+		uint64_t size = ec ? 0 : std::filesystem::file_size(resolved, ec);
+		if (ec) {
+			// Not a plain file under Data (or not accessible), let the inner file system decide.
+			return inner_->OpenFile(file_path);
+		}
+
+		{
+			std::lock_guard lock(mutex_);
+			auto it = entries_.find(key);
+			if (it != entries_.end()) {
+				if (it->second.lastWriteTime == lastWriteTime && it->second.size == size) {
+					lru_.splice(lru_.begin(), lru_, it->second.lruPosition);
+					stats_.hits++;
+					stats_.bytesServedFromCache += size;
+					return it->second.blob->buffer;
+				}
+				logger::debug("CachingFileSystem: {} changed on disk, reloading.", key);
+				EraseLocked(it);
+			}
+			stats_.misses++;
+		}
+
+		RefPtr<Buffer> buffer = inner_->OpenFile(file_path);
+		if (!buffer) return buffer;
+
+		{
+			std::lock_guard lock(mutex_);
+			stats_.bytesReadFromDisk += buffer->size();
+		}
+
+		if (buffer->size() > capacityBytes_ / MAX_ENTRY_FRACTION) {
+			return buffer;
+		}
+
+		std::lock_guard lock(mutex_);
+		if (entries_.contains(key)) {
+			// Another thread cached it while we were reading.
+			return entries_[key].blob->buffer;
+		}
+
+		auto blob = Intern(buffer);
+		lru_.push_front(key);
+		entries_[key] = CacheEntry{ lastWriteTime, size, blob, lru_.begin() };
+		TrimLocked();
+		return blob->buffer;
+	}
+
+	std::shared_ptr<CachingFileSystem::ContentBlob> CachingFileSystem::Intern(RefPtr<Buffer> buffer) {
+		const auto* data = static_cast<const uint8_t*>(buffer->data());
+		uint64_t hash = Fnv1a64(data, buffer->size());
+
+		auto [begin, end] = blobsByHash_.equal_range(hash);
+		for (auto it = begin; it != end; ++it) {
+			auto existing = it->second.lock();
+			if (existing && existing->buffer->size() == buffer->size() &&
+				std::memcmp(existing->buffer->data(), data, buffer->size()) == 0) {
+				existing->users++;
+				stats_.dedupedEntryCount++;
+				return existing;
+			}
+		}
+
+		auto blob = std::make_shared<ContentBlob>();
+		blob->buffer = buffer;
+		blob->hash = hash;
+		blob->users = 1;
+		blobsByHash_.emplace(hash, blob);
+		stats_.cachedBytes += buffer->size();
+		return blob;
+	}
+
+	void CachingFileSystem::EraseLocked(std::unordered_map<std::string, CacheEntry>::iterator it) {
+		auto blob = it->second.blob;
+		lru_.erase(it->second.lruPosition);
+		entries_.erase(it);
+
+		if (--blob->users > 0) {
+			stats_.dedupedEntryCount--;
+			return;
+		}
+
+		stats_.cachedBytes -= blob->buffer->size();
+		auto [begin, end] = blobsByHash_.equal_range(blob->hash);
+		for (auto hashIt = begin; hashIt != end; ++hashIt) {
+			if (hashIt->second.lock() == blob) {
+				blobsByHash_.erase(hashIt);
+				break;
+			}
+		}
+	}
+
+	void CachingFileSystem::TrimLocked() {
+		while (stats_.cachedBytes > capacityBytes_ && !lru_.empty()) {
+			EraseLocked(entries_.find(lru_.back()));
+		}
+	}
+
+	void CachingFileSystem::Invalidate(const std::string& path) {
+		std::lock_guard lock(mutex_);
+		auto it = entries_.find(PackFormat::NormalizePath(path));
+		if (it != entries_.end()) {
+			EraseLocked(it);
+		}
+	}
+
+	void CachingFileSystem::Clear() {
+		std::lock_guard lock(mutex_);
+		lru_.clear();
+		entries_.clear();
+		blobsByHash_.clear();
+		stats_.cachedBytes = 0;
+		stats_.dedupedEntryCount = 0;
+	}
+
+	CacheStats CachingFileSystem::GetStats() {
+		std::lock_guard lock(mutex_);
+		CacheStats stats = stats_;
+		stats.entryCount = static_cast<uint32_t>(entries_.size());
+		return stats;
+	}
+
+	FileSystem* Install(FileSystem* inner, const std::filesystem::path& baseDirectory, uint64_t capacityBytes) {
+		if (capacityBytes == 0 || !inner) {
+			logger::info("CachingFileSystem: Asset cache disabled.");
+			return inner;
+		}
+
+		instance = new CachingFileSystem(inner, baseDirectory, capacityBytes);
+		logger::info("CachingFileSystem: Asset cache enabled with {} MB.", capacityBytes / (1024 * 1024));
+		return instance;
+	}
+
+	CachingFileSystem* Get() {
+		return instance;
+	}
+}
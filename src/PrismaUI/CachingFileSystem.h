@@ -0,0 +1,88 @@
+﻿#pragma once
+
+#include <Ultralight/Ultralight.h>
+#include <Ultralight/platform/FileSystem.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace PrismaUI::CachingFileSystem {
+	using namespace ultralight;
+
+	// Files larger than this share of the cache capacity are passed through uncached.
+	constexpr uint64_t MAX_ENTRY_FRACTION = 4;
+
+	struct CacheStats {
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		uint64_t bytesServedFromCache = 0;
+		uint64_t bytesReadFromDisk = 0;
+		uint64_t cachedBytes = 0;
+		uint64_t capacityBytes = 0;
+		uint32_t entryCount = 0;
+		// Cached paths whose contents matched an already cached file and share its buffer.
+		uint32_t dedupedEntryCount = 0;
+	};
+
+	// LRU cache of loose-file contents in front of another FileSystem, shared by all views.
+	// Entries are keyed by path and revalidated against the file's mtime and size on every open.
+	// Identical files under different paths (the same framework bundle shipped by several mods)
+	// are stored once.
+	class CachingFileSystem : public FileSystem {
+	public:
+		CachingFileSystem(FileSystem* inner, std::filesystem::path baseDirectory, uint64_t capacityBytes);
+		virtual ~CachingFileSystem() = default;
+
+		CachingFileSystem(const CachingFileSystem&) = delete;
+		CachingFileSystem& operator=(const CachingFileSystem&) = delete;
+
+		virtual bool FileExists(const String& file_path) override;
+		virtual String GetFileMimeType(const String& file_path) override;
+		virtual String GetFileCharset(const String& file_path) override;
+		virtual RefPtr<Buffer> OpenFile(const String& file_path) override;
+
+		void Invalidate(const std::string& path);
+		void Clear();
+		CacheStats GetStats();
+
+	private:
+		struct ContentBlob {
+			RefPtr<Buffer> buffer;
+			uint64_t hash = 0;
+			uint32_t users = 0;
+		};
+
+		struct CacheEntry {
+			std::filesystem::file_time_type lastWriteTime;
+			uint64_t size = 0;
+			std::shared_ptr<ContentBlob> blob;
+			std::list<std::string>::iterator lruPosition;
+		};
+
+		std::filesystem::path Resolve(const std::string& key) const;
+		std::shared_ptr<ContentBlob> Intern(RefPtr<Buffer> buffer);
+		void EraseLocked(std::unordered_map<std::string, CacheEntry>::iterator it);
+		void TrimLocked();
+
+		FileSystem* inner_;
+		std::filesystem::path baseDirectory_;
+		uint64_t capacityBytes_;
+
+		std::mutex mutex_;
+		std::list<std::string> lru_;
+		std::unordered_map<std::string, CacheEntry> entries_;
+		std::unordered_multimap<uint64_t, std::weak_ptr<ContentBlob>> blobsByHash_;
+		CacheStats stats_;
+	};
+
+	// Creates the process-wide cache in front of inner. Returns inner unchanged when capacityBytes is 0.
+	FileSystem* Install(FileSystem* inner, const std::filesystem::path& baseDirectory, uint64_t capacityBytes);
+
+	// The installed cache, or nullptr when caching is disabled.
+	CachingFileSystem* Get();
+}
@@ -1,20 +1,16 @@
 ﻿#include "Communication.h"
 #include "Core.h"
 #include "ViewManager.h"
+#include "ScriptScheduler.h"
+
+#include <Utils/DeferredLog/DeferredLog.h>
 
 namespace PrismaUI::Communication {
 	using namespace Core;
 	using namespace ViewManager;
 
 	void Invoke(const Core::PrismaViewId& viewId, const String& script, std::function<void(std::string)> callback) {
-		std::shared_ptr<PrismaView> viewData = nullptr;
-		{
-			std::shared_lock lock(viewsMutex);
-			auto it = views.find(viewId);
-			if (it != views.end()) {
-				viewData = it->second;
-			}
-		}
+		std::shared_ptr<PrismaView> viewData = FindView(viewId);
 
 		if (!viewData) {
 			logger::warn("Invoke: View ID [{}] not found.", viewId);
@@ -24,7 +20,7 @@ namespace PrismaUI::Communication {
 			return;
 		}
 
-		ultralightThread.submit([view_ptr = viewData->ultralightView, script_copy = script, callback]() {
+		ScriptScheduler::Enqueue(viewData, [script_copy = script, callback](View* view_ptr) {
 			String result = "";
 			if (view_ptr) {
 				try {
@@ -60,31 +56,17 @@ namespace PrismaUI::Communication {
 			logger::debug("RegisterJSListener: Registered callback '{}' for view [{}]", name, viewId);
 		}
 
-		std::shared_ptr<PrismaView> viewData = nullptr;
-		{
-			std::shared_lock lock(viewsMutex);
-			auto it = views.find(viewId);
-			if (it != views.end()) {
-				viewData = it->second;
-			}
-		}
+		std::shared_ptr<PrismaView> viewData = FindView(viewId);
 
 		if (viewData && viewData->ultralightView && viewData->isLoadingFinished) {
-			ultralightThread.submit([viewId, name]() {
+			ultralightThread.submit_ordered(TaskPriority::Interop, viewId, [viewId, name]() {
 				BindJSCallbacks(viewId);
 				});
 		}
 	}
 
 	void BindJSCallbacks(const Core::PrismaViewId& viewId) {
-		std::shared_ptr<PrismaView> viewData = nullptr;
-		{
-			std::shared_lock lock(viewsMutex);
-			auto it = views.find(viewId);
-			if (it != views.end()) {
-				viewData = it->second;
-			}
-		}
+		std::shared_ptr<PrismaView> viewData = FindView(viewId);
 
 		if (!viewData || !viewData->ultralightView || !viewData->isLoadingFinished) {
 			logger::warn("BindJSCallbacks: View [{}] not ready or not loaded.", viewId);
@@ -151,12 +133,12 @@ namespace PrismaUI::Communication {
 		JSObjectRef thisObject, size_t argumentCount,
 		const JSValueRef arguments[], JSValueRef* exception) {
 
-		logger::debug("JSCallbackDispatcher: Entered.");
+		DeferredLog::debug("JSCallbackDispatcher: Entered.");
 
 		Core::JSCallbackData* callbackDataPtr = static_cast<Core::JSCallbackData*>(JSObjectGetPrivate(function));
 
 		if (!callbackDataPtr) {
-			logger::error("JSCallbackDispatcher: Failed to get private data (C++ JSCallbackData*) from function object.");
+			DeferredLog::error("JSCallbackDispatcher: Failed to get private data (C++ JSCallbackData*) from function object.");
 			if (exception) {
 				JSStringRef errorStr = JSStringCreateWithUTF8CString("Internal C++ error: private data (callback ptr) missing for JS callback.");
 				*exception = JSValueMakeString(ctx, errorStr);
@@ -164,13 +146,13 @@ namespace PrismaUI::Communication {
 			}
 			return JSValueMakeNull(ctx);
 		}
-		logger::debug("JSCallbackDispatcher: Private data (C++ JSCallbackData*) retrieved. Name: '{}', ViewID: '{}'", callbackDataPtr->name, callbackDataPtr->viewId);
+		DeferredLog::debug("JSCallbackDispatcher: Private data (C++ JSCallbackData*) retrieved. Name: '{}', ViewID: '{}'", callbackDataPtr->name, callbackDataPtr->viewId);
 
 		Core::PrismaViewId retrievedViewId = callbackDataPtr->viewId;
 		std::string retrievedName = callbackDataPtr->name;
 		Core::SimpleJSCallback targetCallback = callbackDataPtr->callback;
 
-		logger::debug("JSCallbackDispatcher: Retrieved from C++ pointer -> View ID: '{}', Name: '{}'", retrievedViewId, retrievedName);
+		DeferredLog::debug("JSCallbackDispatcher: Retrieved from C++ pointer -> View ID: '{}', Name: '{}'", retrievedViewId, retrievedName);
 
 		std::string paramStrData;
 		if (argumentCount > 0) {
@@ -182,10 +164,10 @@ namespace PrismaUI::Communication {
 					JSStringGetUTF8CString(jsStrParam, paramBuffer.data(), paramBufferSize);
 					JSStringRelease(jsStrParam);
 					paramStrData = paramBuffer.data();
-					logger::debug("JSCallbackDispatcher: Arg 0 (string): '{}'", paramStrData);
+					DeferredLog::debug("JSCallbackDispatcher: Arg 0 (string): '{}'", paramStrData);
 				}
 				else {
-					logger::warn("JSCallbackDispatcher: Arg 0 was not convertible to string (JSValueToStringCopy failed).");
+					DeferredLog::warn("JSCallbackDispatcher: Arg 0 was not convertible to string (JSValueToStringCopy failed).");
 					if (exception && (!(*exception) || JSValueIsNull(ctx, *exception))) {
 						JSStringRef errorStr = JSStringCreateWithUTF8CString("C++ callback expected a string argument, but conversion failed.");
 						*exception = JSValueMakeString(ctx, errorStr);
@@ -194,7 +176,7 @@ namespace PrismaUI::Communication {
 				}
 			}
 			else {
-				logger::warn("JSCallbackDispatcher: Arg 0 passed from JS was not a string type.");
+				DeferredLog::warn("JSCallbackDispatcher: Arg 0 passed from JS was not a string type.");
 				if (exception) {
 					JSStringRef errorStr = JSStringCreateWithUTF8CString("C++ callback expected a string argument, but received a different type.");
 					*exception = JSValueMakeString(ctx, errorStr);
@@ -203,25 +185,25 @@ namespace PrismaUI::Communication {
 			}
 		}
 		else {
-			logger::debug("JSCallbackDispatcher: No arguments passed from JS. Expected 1 string argument.");
+			DeferredLog::debug("JSCallbackDispatcher: No arguments passed from JS. Expected 1 string argument.");
 		}
 
 		if (targetCallback) {
-			logger::debug("JSCallbackDispatcher: Target callback found. Invoking with data: '{}'", paramStrData);
+			DeferredLog::debug("JSCallbackDispatcher: Target callback found. Invoking with data: '{}'", paramStrData);
 			try {
 				targetCallback(paramStrData);
 
-				logger::debug("JSCallbackDispatcher: Target callback invoked successfully.");
+				DeferredLog::debug("JSCallbackDispatcher: Target callback invoked successfully.");
 			}
 			catch (const std::exception& e) {
-				logger::error("JSCallbackDispatcher: C++ exception in registered callback for '{}'/'{}': {}", retrievedName, retrievedViewId, e.what());
+				DeferredLog::error("JSCallbackDispatcher: C++ exception in registered callback for '{}'/'{}': {}", retrievedName, retrievedViewId, e.what());
 			}
 			catch (...) {
-				logger::error("JSCallbackDispatcher: Unknown C++ exception in registered callback for '{}'/'{}'", retrievedName, retrievedViewId);
+				DeferredLog::error("JSCallbackDispatcher: Unknown C++ exception in registered callback for '{}'/'{}'", retrievedName, retrievedViewId);
 			}
 		}
 		else {
-			logger::warn("JSCallbackDispatcher: Target callback was null within JSCallbackData for View ID: '{}', Name: '{}'", retrievedViewId, retrievedName);
+			DeferredLog::warn("JSCallbackDispatcher: Target callback was null within JSCallbackData for View ID: '{}', Name: '{}'", retrievedViewId, retrievedName);
 			if (exception) {
 				std::string errMsg = "Internal C++ error: Callback function pointer was null for " + retrievedName;
 				JSStringRef errorStr = JSStringCreateWithUTF8CString(errMsg.c_str());
@@ -229,19 +211,12 @@ namespace PrismaUI::Communication {
 				JSStringRelease(errorStr);
 			}
 		}
-		logger::debug("JSCallbackDispatcher: Exiting.");
+		DeferredLog::debug("JSCallbackDispatcher: Exiting.");
 		return JSValueMakeNull(ctx);
 	}
 
 	void InteropCall(const Core::PrismaViewId& viewId, const std::string& functionName, const std::string& argument) {
-		std::shared_ptr<PrismaView> viewData = nullptr;
-		{
-			std::shared_lock lock(viewsMutex);
-			auto it = views.find(viewId);
-			if (it != views.end()) {
-				viewData = it->second;
-			}
-		}
+		std::shared_ptr<PrismaView> viewData = FindView(viewId);
 
 		if (!viewData) {
 			logger::warn("InteropCall: View ID [{}] not found.", viewId);
@@ -253,7 +228,7 @@ namespace PrismaUI::Communication {
 			return;
 		}
 
-		ultralightThread.submit([view_ptr = viewData->ultralightView, funcName = functionName, arg = argument, viewId]() {
+		ScriptScheduler::Enqueue(viewData, [funcName = functionName, arg = argument, viewId](View* view_ptr) {
 			if (!view_ptr) {
 				return;
 			}
@@ -309,13 +284,13 @@ namespace PrismaUI::Communication {
 		JSObjectRef thisObject, size_t argumentCount,
 		const JSValueRef arguments[], JSValueRef* exception) {
 
-		logger::debug("InvokeCppCallback: Called from JavaScript");
+		DeferredLog::debug("InvokeCppCallback: Called from JavaScript");
 
 		JSValueRef dataValue = JSObjectGetProperty(ctx, function,
 			JSStringCreateWithUTF8CString("data"), exception);
 
 		if (!dataValue || JSValueIsNull(ctx, dataValue) || JSValueIsUndefined(ctx, dataValue)) {
-			logger::error("InvokeCppCallback: No data attached to the function");
+			DeferredLog::error("InvokeCppCallback: No data attached to the function");
 			return JSValueMakeUndefined(ctx);
 		}
 
@@ -324,7 +299,7 @@ namespace PrismaUI::Communication {
 
 		JSObjectRef dataObj = JSValueToObject(ctx, dataValue, exception);
 		if (!dataObj) {
-			logger::error("InvokeCppCallback: Failed to convert data to object");
+			DeferredLog::error("InvokeCppCallback: Failed to convert data to object");
 			JSStringRelease(viewIdKey);
 			JSStringRelease(nameKey);
 			return JSValueMakeUndefined(ctx);
@@ -337,7 +312,7 @@ namespace PrismaUI::Communication {
 		JSStringRelease(nameKey);
 
 		if (!viewIdValue || !nameValue) {
-			logger::error("InvokeCppCallback: Failed to get viewId or name from data object");
+			DeferredLog::error("InvokeCppCallback: Failed to get viewId or name from data object");
 			return JSValueMakeUndefined(ctx);
 		}
 
@@ -345,7 +320,7 @@ namespace PrismaUI::Communication {
 		JSStringRef nameStr = JSValueToStringCopy(ctx, nameValue, exception);
 
 		if (!viewIdStr || !nameStr) {
-			logger::error("InvokeCppCallback: Failed to convert viewId or name to string");
+			DeferredLog::error("InvokeCppCallback: Failed to convert viewId or name to string");
 			if (viewIdStr) JSStringRelease(viewIdStr);
 			if (nameStr) JSStringRelease(nameStr);
 			return JSValueMakeUndefined(ctx);
@@ -366,7 +341,7 @@ namespace PrismaUI::Communication {
 		Core::PrismaViewId viewId = std::stoull(std::string(viewIdBuffer.data()));
 		std::string name(nameBuffer.data());
 
-		logger::debug("InvokeCppCallback: Looking for callback viewId={}, name={}", viewId, name);
+		DeferredLog::debug("InvokeCppCallback: Looking for callback viewId={}, name={}", viewId, name);
 
 		std::string paramStr;
 		if (argumentCount > 0) {
@@ -390,21 +365,21 @@ namespace PrismaUI::Communication {
 		}
 
 		if (targetCallback) {
-			logger::debug("InvokeCppCallback: Found callback. Invoking with data: '{}'", paramStr);
+			DeferredLog::debug("InvokeCppCallback: Found callback. Invoking with data: '{}'", paramStr);
 			try {
 				targetCallback(paramStr);
 
-				logger::debug("InvokeCppCallback: Callback invoked successfully");
+				DeferredLog::debug("InvokeCppCallback: Callback invoked successfully");
 			}
 			catch (const std::exception& e) {
-				logger::error("InvokeCppCallback: Exception in callback: {}", e.what());
+				DeferredLog::error("InvokeCppCallback: Exception in callback: {}", e.what());
 			}
 			catch (...) {
-				logger::error("InvokeCppCallback: Unknown exception in callback");
+				DeferredLog::error("InvokeCppCallback: Unknown exception in callback");
 			}
 		}
 		else {
-			logger::error("InvokeCppCallback: Callback not found for viewId={}, name={}", viewId, name);
+			DeferredLog::error("InvokeCppCallback: Callback not found for viewId={}, name={}", viewId, name);
 			if (exception) {
 				std::string errMsg = "C++ callback not found: " + name + " for view " + std::to_string(viewId);
 				JSStringRef errorStr = JSStringCreateWithUTF8CString(errMsg.c_str());
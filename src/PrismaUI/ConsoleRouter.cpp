@@ -0,0 +1,198 @@
+﻿#include "ConsoleRouter.h"
+#include "Core.h"
+#include "Settings.h"
+
+#include <Utils/DeferredLog/DeferredLog.h>
+
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+
+namespace PrismaUI::ConsoleRouter {
+	using namespace Core;
+	using Clock = std::chrono::steady_clock;
+
+	struct ViewConsoleState {
+		std::string name;
+
+		double tokens = -1.0;
+		Clock::time_point lastRefill{};
+		uint64_t suppressedCount = 0;
+
+		std::string lastMessage;
+		DeferredLog::Level lastLevel = DeferredLog::Level::Info;
+		uint64_t repeatCount = 0;
+		Clock::time_point lastSeen{};
+
+		// Only written to on the I/O thread.
+		std::shared_ptr<std::ofstream> file;
+	};
+
+	static std::mutex statesMutex;
+	static std::unordered_map<PrismaViewId, ViewConsoleState> states;
+
+	static const char* LEVEL_LABELS[] = { "trace", "debug", "info", "warn", "error", "critical", "off" };
+
+	static DeferredLog::Level MapLevel(ultralight::MessageLevel level) {
+		switch (level) {
+		case ultralight::kMessageLevel_Debug: return DeferredLog::Level::Debug;
+		case ultralight::kMessageLevel_Warning: return DeferredLog::Level::Warn;
+		case ultralight::kMessageLevel_Error: return DeferredLog::Level::Error;
+		case ultralight::kMessageLevel_Log:
+		case ultralight::kMessageLevel_Info:
+		default: return DeferredLog::Level::Info;
+		}
+	}
+
+	static std::string SanitizeFileName(const std::string& text) {
+		std::string result;
+		for (char c : text) {
+			bool allowed = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_';
+			result.push_back(allowed ? c : '_');
+		}
+		return result.substr(0, 64);
+	}
+
+	static void OpenFileLocked(PrismaViewId viewId, ViewConsoleState& state) {
+		if (state.file || !ioThread) return;
+
+		std::string fileName = (state.name.empty() ? std::string("view") : SanitizeFileName(state.name)) + "-" + std::to_string(viewId) + ".log";
+		auto path = std::filesystem::path(CONSOLE_LOG_DIRECTORY) / fileName;
+		state.file = std::make_shared<std::ofstream>();
+
+		ioThread->submit([file = state.file, path]() {
+			std::error_code ec;
+			std::filesystem::create_directories(path.parent_path(), ec);
+			file->open(path, std::ios::out | std::ios::trunc);
+			if (!*file) {
+				logger::warn("ConsoleRouter: Cannot open console file {}", path.string());
+			}
+			});
+	}
+
+	static void Emit(PrismaViewId viewId, ViewConsoleState& state, DeferredLog::Level level, const std::string& text) {
+		DeferredLog::log(level, "View [{}]: JSConsole: {}", viewId, text);
+
+		if (!Settings::Get().console.perViewFiles || !ioThread) return;
+
+		try {
+			OpenFileLocked(viewId, state);
+			ioThread->submit([file = state.file, level, text]() {
+				if (*file) {
+					*file << '[' << LEVEL_LABELS[static_cast<size_t>(level)] << "] " << text << '\n';
+				}
+				});
+		}
+		catch (const std::exception&) {
+			// I/O thread is shutting down, the message still reached the main log.
+		}
+	}
+
+	static void FlushRepeatsLocked(PrismaViewId viewId, ViewConsoleState& state) {
+		if (state.repeatCount == 0) return;
+		Emit(viewId, state, state.lastLevel, "(previous message repeated " + std::to_string(state.repeatCount) + " more time(s))");
+		state.repeatCount = 0;
+	}
+
+	static bool TakeToken(ViewConsoleState& state, Clock::time_point now) {
+		const auto& consoleSettings = Settings::Get().console;
+		if (consoleSettings.messagesPerSecond <= 0.0) return true;
+
+		double burst = static_cast<double>(consoleSettings.burst);
+		if (state.tokens < 0.0) {
+			state.tokens = burst;
+			state.lastRefill = now;
+		}
+
+		double elapsed = std::chrono::duration<double>(now - state.lastRefill).count();
+		state.tokens = std::min(burst, state.tokens + elapsed * consoleSettings.messagesPerSecond);
+		state.lastRefill = now;
+
+		if (state.tokens < 1.0) return false;
+		state.tokens -= 1.0;
+		return true;
+	}
+
+	void RegisterView(Core::PrismaViewId viewId, const std::string& htmlPath) {
+		std::lock_guard lock(statesMutex);
+		auto slash = htmlPath.find_last_of("/\\");
+		std::string name = slash == std::string::npos ? htmlPath : htmlPath.substr(slash + 1);
+		auto dot = name.find_last_of('.');
+		states[viewId].name = dot == std::string::npos ? name : name.substr(0, dot);
+	}
+
+	void RemoveView(Core::PrismaViewId viewId) {
+		std::lock_guard lock(statesMutex);
+		auto it = states.find(viewId);
+		if (it == states.end()) return;
+
+		FlushRepeatsLocked(viewId, it->second);
+		if (it->second.file && ioThread) {
+			try {
+				ioThread->submit([file = it->second.file]() {
+					file->close();
+					});
+			}
+			catch (const std::exception&) {}
+		}
+		states.erase(it);
+	}
+
+	void Route(Core::PrismaViewId viewId, const ultralight::ConsoleMessage& message) {
+		const auto& consoleSettings = Settings::Get().console;
+		DeferredLog::Level level = MapLevel(message.level());
+		if (level < consoleSettings.minLevel) return;
+
+		std::string text = message.message().utf8().data();
+		if (level >= DeferredLog::Level::Warn) {
+			const auto& source = message.source_id().utf8();
+			if (source.length() > 0) {
+				text += " (" + std::string(source.data(), source.length()) + ":" + std::to_string(message.line_number()) + ")";
+			}
+		}
+
+		auto now = Clock::now();
+		std::lock_guard lock(statesMutex);
+		// Messages can still arrive after RemoveView, they are dropped rather than recreating the state.
+		auto it = states.find(viewId);
+		if (it == states.end()) return;
+		auto& state = it->second;
+
+		if (consoleSettings.deduplicate && state.lastSeen != Clock::time_point{} && level == state.lastLevel && text == state.lastMessage) {
+			state.repeatCount++;
+			state.lastSeen = now;
+			return;
+		}
+
+		FlushRepeatsLocked(viewId, state);
+
+		if (!TakeToken(state, now)) {
+			state.suppressedCount++;
+			return;
+		}
+
+		if (state.suppressedCount > 0) {
+			Emit(viewId, state, DeferredLog::Level::Warn, std::to_string(state.suppressedCount) + " console message(s) suppressed by rate limit");
+			state.suppressedCount = 0;
+		}
+
+		Emit(viewId, state, level, text);
+		state.lastMessage = std::move(text);
+		state.lastLevel = level;
+		state.lastSeen = now;
+	}
+
+	void Tick() {
+		auto now = Clock::now();
+		std::lock_guard lock(statesMutex);
+		for (auto& [viewId, state] : states) {
+			if (state.repeatCount > 0 && now - state.lastSeen >= REPEAT_FLUSH_DELAY) {
+				FlushRepeatsLocked(viewId, state);
+			}
+			if (state.suppressedCount > 0 && now - state.lastRefill >= REPEAT_FLUSH_DELAY) {
+				Emit(viewId, state, DeferredLog::Level::Warn, std::to_string(state.suppressedCount) + " console message(s) suppressed by rate limit");
+				state.suppressedCount = 0;
+			}
+		}
+	}
+}
@@ -0,0 +1,30 @@
+﻿#pragma once
+
+#include <Ultralight/Ultralight.h>
+#include <Ultralight/ConsoleMessage.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace PrismaUI::Core {
+	typedef uint64_t PrismaViewId;
+}
+
+namespace PrismaUI::ConsoleRouter {
+	constexpr auto CONSOLE_LOG_DIRECTORY = "Data/SKSE/Plugins/PrismaUI/Console";
+	// A run of identical messages is summarized once it has been quiet for this long.
+	constexpr auto REPEAT_FLUSH_DELAY = std::chrono::seconds(1);
+
+	// Remembers the view's page so its console file gets a readable name.
+	void RegisterView(Core::PrismaViewId viewId, const std::string& htmlPath);
+
+	// Flushes pending repeat/suppression summaries and closes the view's console file.
+	void RemoveView(Core::PrismaViewId viewId);
+
+	// Filters, deduplicates and rate limits a console message, then logs it. UI thread.
+	void Route(Core::PrismaViewId viewId, const ultralight::ConsoleMessage& message);
+
+	// Emits "repeated N times" summaries for runs that went quiet. Called once per frame on the UI thread.
+	void Tick();
+}
@@ -5,6 +5,18 @@
 #include "InputHandler.h"
 #include "Communication.h"
 #include "ViewOperationQueue.h"
+#include "Settings.h"
+#include "MemoryGovernor.h"
+#include "ViewCreationScheduler.h"
+#include "PackFileSystem.h"
+#include "CachingFileSystem.h"
+#include "FontCache.h"
+#include "ConsoleRouter.h"
+#include "ScriptScheduler.h"
+#include "HotReload.h"
+
+#include <algorithm>
+#include <filesystem>
 
 namespace PrismaUI::Core {
 	using namespace PrismaUI::Listeners;
@@ -14,6 +26,8 @@ namespace PrismaUI::Core {
 
 	SingleThreadExecutor ultralightThread;
 	std::unique_ptr<RepeatingTaskRunner> logicRunner;
+	std::unique_ptr<WorkerPool> frameCopyWorkers;
+	std::unique_ptr<SingleThreadExecutor> ioThread;
 	NanoIdGenerator generator;
 	std::atomic<bool> coreInitialized = false;
 
@@ -30,33 +44,90 @@ namespace PrismaUI::Core {
 
 	std::map<PrismaViewId, std::shared_ptr<PrismaView>> views;
 	std::shared_mutex viewsMutex;
+	static std::atomic<std::shared_ptr<const ViewSnapshot>> viewSnapshot{ std::make_shared<const ViewSnapshot>() };
+	std::map<std::string, RefPtr<Session>> sessions;
 
 	std::map<std::pair<PrismaViewId, std::string>, JSCallbackData> PrismaUI::Core::jsCallbacks;
 	std::mutex PrismaUI::Core::jsCallbacksMutex;
 
 	inline REL::Relocation<Hooks::D3DPresentHook::D3DPresentFunc> RealD3dPresentFunc;
 
+	PrismaView::PrismaView(ViewSlot frameSlot) :
+		slot(frameSlot),
+		isHidden(frameTable.isHidden[frameSlot]),
+		isHibernated(frameTable.isHibernated[frameSlot]),
+		newFrameReady(frameTable.newFrameReady[frameSlot]),
+		pendingResourceRelease(frameTable.pendingResourceRelease[frameSlot]),
+		queuedOperationsCount(frameTable.queuedOperationsCount[frameSlot]),
+		texture(frameTable.texture[frameSlot]),
+		textureView(frameTable.textureView[frameSlot]),
+		textureWidth(frameTable.textureWidth[frameSlot]),
+		textureHeight(frameTable.textureHeight[frameSlot]),
+		order(frameTable.order[frameSlot]) {
+	}
+
 	PrismaView::~PrismaView() {
-		ViewRenderer::ReleaseViewTexture(this);
+		ViewRenderer::ReleaseSlotTexture(slot);
+		ReleaseViewSlot(slot);
+	}
+
+	static void DeferredLogSink(DeferredLog::Level level, std::string_view message) {
+		switch (level) {
+		case DeferredLog::Level::Trace: logger::trace("{}", message); break;
+		case DeferredLog::Level::Debug: logger::debug("{}", message); break;
+		case DeferredLog::Level::Info: logger::info("{}", message); break;
+		case DeferredLog::Level::Warn: logger::warn("{}", message); break;
+		case DeferredLog::Level::Error: logger::error("{}", message); break;
+		case DeferredLog::Level::Critical: logger::critical("{}", message); break;
+		default: break;
+		}
 	}
 
 	void InitializeCoreSystem() {
 		logger::info("Initializing PrismaUI Core System...");
+		Settings::Load();
+		Settings::LogEffectiveSettings();
+
+		DeferredLog::SetLevel(Settings::Get().logging.deferredLevel);
+		DeferredLog::Start(&DeferredLogSink);
+
+		const auto& memorySettings = Settings::Get().memory;
+		bool largePages = BufferArena::Configure(memorySettings.frameBufferCacheBytes, memorySettings.largePageFrameBuffers);
+		if (memorySettings.largePageFrameBuffers && !largePages) {
+			logger::warn("Large pages are unavailable (missing \"Lock pages in memory\" privilege?), frame buffers use regular pages.");
+		}
+
 		InitHooks();
 
 		logicRunner = std::make_unique<RepeatingTaskRunner>([]() {
 			ultralightThread.submit(&UpdateLogic).get();
 			});
 
+		const uint32_t copyWorkerCount = Settings::Get().renderer.frameCopyWorkers;
+		if (copyWorkerCount > 1) {
+			frameCopyWorkers = std::make_unique<WorkerPool>(copyWorkerCount);
+			logger::info("Frame copy worker pool started with {} thread(s).", copyWorkerCount);
+		}
+
+		ioThread = std::make_unique<SingleThreadExecutor>();
+
 		ultralightThread.submit([] {
 			try {
 				Platform& plat = Platform::instance();
 				plat.set_logger(new MyUltralightLogger());
-				plat.set_font_loader(ultralight::GetPlatformFontLoader());
-
-				plat.set_file_system(ultralight::GetPlatformFileSystem("."));
+				plat.set_font_loader(FontCache::Install(ultralight::GetPlatformFontLoader()));
+
+				FileSystem* fileSystem = ultralight::GetPlatformFileSystem(".");
+				fileSystem = CachingFileSystem::Install(fileSystem, ".", Settings::Get().fileSystem.assetCacheBytes);
+				if (Settings::Get().fileSystem.enablePacks) {
+					auto packFileSystem = new PackFileSystem::PackFileSystem(fileSystem);
+					packFileSystem->MountDirectory(PackFileSystem::PACKS_DIRECTORY);
+					fileSystem = packFileSystem;
+				}
+				plat.set_file_system(fileSystem);
 
 				Config config;
+				Settings::ApplyToConfig(config);
 				plat.set_config(config);
 
 				renderer = Renderer::Create();
@@ -78,6 +149,8 @@ namespace PrismaUI::Core {
 		auto ui = RE::UI::GetSingleton();
 		ui->Register(FocusMenu::MENU_NAME, FocusMenu::Creator);
 
+		HotReload::Start();
+
 		logger::info("PrismaUI Core System Initialized.");
 	}
 
@@ -156,122 +229,176 @@ namespace PrismaUI::Core {
 
 		if (!coreInitialized) return;
 
+		// Views destroyed since the last frame, their textures are only ever released here.
+		ViewRenderer::ReleaseDeferredViews();
+
 		if (!d3dDevice || !d3dContext || !spriteBatch || !commonStates || !hWnd || screenSize.width == 0) {
 			InitGraphics();
 			if (!d3dDevice || !d3dContext || !spriteBatch || !commonStates || !hWnd || screenSize.width == 0) return;
 		}
 
-		std::vector<PrismaViewId> viewsWithPendingRelease;
-		{
-			std::shared_lock lock(viewsMutex);
-			for (const auto& pair : views) {
-				if (pair.second && pair.second->pendingResourceRelease.load()) {
-					viewsWithPendingRelease.push_back(pair.first);
-				}
+		const auto snapshot = GetViewSnapshot();
+
+		for (ViewSlot slot : snapshot->slots) {
+			if (frameTable.pendingResourceRelease[slot].load()) {
+				ViewRenderer::ReleaseSlotTexture(slot);
+				frameTable.pendingResourceRelease[slot] = false;
 			}
 		}
 
-		for (const auto& viewId : viewsWithPendingRelease) {
-			std::shared_ptr<PrismaView> viewData = nullptr;
-			{
-				std::shared_lock lock(viewsMutex);
-				auto it = views.find(viewId);
-				if (it != views.end()) {
-					viewData = it->second;
-				}
-			}
+		// Process pending operations for all views
+		ViewOperationQueue::ProcessAllViewOperations(*snapshot);
 
-			if (viewData) {
-				logger::debug("D3DPresent: Releasing D3D resources for View [{}] from render thread", viewId);
-				ViewRenderer::ReleaseViewTexture(viewData.get());
-				viewData->pendingResourceRelease = false;
-			}
+		const bool loadingScreenActive = IsLoadingScreenActive();
+		if (loadingScreenActive && Settings::Get().fonts.preloadOnLoadingScreen) {
+			FontCache::RequestPreload();
 		}
 
-		// Process pending operations for all views
-		ViewOperationQueue::ProcessAllViewOperations();
+		const bool prewarmAllowed = loadingScreenActive || !InputHandler::IsAnyInputCaptureActive();
 
-		ultralightThread.submit([dev = d3dDevice, ctx = d3dContext, hwnd = hWnd]() {
+		ultralightThread.submit([dev = d3dDevice, ctx = d3dContext, hwnd = hWnd, prewarmAllowed]() {
 			if (!dev || !ctx || !hwnd || !renderer) return;
 
-			std::vector<std::shared_ptr<PrismaView>> viewsToInitialize;
-			{
-				std::shared_lock lock(viewsMutex);
-				for (auto& pair : views) {
-					if (pair.second && !pair.second->ultralightView && !pair.second->htmlPathToLoad.empty()) {
-						viewsToInitialize.push_back(pair.second);
-					}
-				}
+			// Loaded here rather than captured: Destroy drops a view from the snapshot before queuing its
+			// UI-thread teardown, so a snapshot taken on this thread never holds a view already torn down.
+			const auto uiSnapshot = GetViewSnapshot();
+
+			ViewCreationScheduler::ProcessPendingCreations(*uiSnapshot, prewarmAllowed);
+
+			ProcessEvents();
+			ConsoleRouter::Tick();
+			ScriptScheduler::ProcessPendingScripts(*uiSnapshot);
+
+			if (renderer) {
+				renderer->RefreshDisplay(ViewManager::ACTIVE_DISPLAY_ID);
+				RenderActiveViews(*uiSnapshot);
 			}
 
-			for (auto& viewData : viewsToInitialize) {
-				if (viewData->ultralightView) continue;
+			RenderViews(*uiSnapshot);
+			});
 
-				logger::info("UI Thread: Creating View [{}] for path: {}", viewData->id, viewData->htmlPathToLoad);
+		// Only views with a new frame are touched, the rest is a scan over frameTable.newFrameReady.
+		for (size_t i = 0; i < snapshot->slots.size(); ++i) {
+			if (frameTable.newFrameReady[snapshot->slots[i]].load(std::memory_order_relaxed)) {
+				UpdateSingleTextureFromBuffer(snapshot->views[i]);
+			}
+		}
 
-				if (screenSize.width == 0 || screenSize.height == 0) {
-					logger::error("UI Thread: Cannot create View [{}], screen size is zero.", viewData->id);
-					continue;
-				}
+		DrawViews(*snapshot);
+		DrawCursor();
 
-				ViewConfig view_config;
-				view_config.is_accelerated = false;
-				view_config.is_transparent = true;
-				view_config.initial_focus = false;
-				view_config.enable_images = true;
-				view_config.enable_javascript = true;
-				view_config.enable_compositor = false;
-
-				viewData->ultralightView = renderer->CreateView(screenSize.width, screenSize.height, view_config, nullptr);
-
-				if (viewData->ultralightView) {
-					viewData->loadListener = std::make_unique<Listeners::MyLoadListener>(viewData->id);
-					viewData->viewListener = std::make_unique<Listeners::MyViewListener>(viewData->id);
-					viewData->ultralightView->set_load_listener(viewData->loadListener.get());
-					viewData->ultralightView->set_view_listener(viewData->viewListener.get());
-					viewData->ultralightView->LoadURL(String(viewData->htmlPathToLoad.c_str()));
-					viewData->ultralightView->Unfocus();
-					viewData->htmlPathToLoad.clear();
-					logger::info("UI Thread: View [{}] successfully created and loading URL.", viewData->id);
-				}
-				else {
-					logger::error("UI Thread: Failed to create Ultralight View for ID [{}].", viewData->id);
-					viewData->htmlPathToLoad = "[CREATION FAILED]";
-				}
+		MemoryGovernor::Tick();
+	}
+
+	std::shared_ptr<const ViewSnapshot> GetViewSnapshot() {
+		return viewSnapshot.load(std::memory_order_acquire);
+	}
+
+	void PublishViewSnapshot() {
+		auto snapshot = std::make_shared<ViewSnapshot>();
+		snapshot->views.reserve(views.size());
+		snapshot->slots.reserve(views.size());
+		for (const auto& pair : views) {
+			if (pair.second) {
+				snapshot->views.push_back(pair.second);
+				snapshot->slots.push_back(pair.second->slot);
 			}
+		}
+		snapshot->drawOrder = snapshot->slots;
+		// Stable sort keeps id order between views with the same order.
+		std::stable_sort(snapshot->drawOrder.begin(), snapshot->drawOrder.end(), [](ViewSlot a, ViewSlot b) {
+			return frameTable.order[a] < frameTable.order[b];
+			});
+		viewSnapshot.store(std::move(snapshot), std::memory_order_release);
+	}
 
-			ProcessEvents();
+	std::shared_ptr<PrismaView> FindView(const PrismaViewId& viewId) {
+		auto snapshot = GetViewSnapshot();
+		auto it = std::lower_bound(snapshot->views.begin(), snapshot->views.end(), viewId,
+			[](const std::shared_ptr<PrismaView>& viewData, const PrismaViewId& id) { return viewData->id < id; });
+		if (it != snapshot->views.end() && (*it)->id == viewId) {
+			return *it;
+		}
+		return nullptr;
+	}
 
-			if (renderer) {
-				renderer->RefreshDisplay(0);
-				renderer->Render();
+	std::string SanitizeSessionName(std::string_view name) {
+		// Session names become folder names under the cache path.
+		std::string result;
+		for (char c : name) {
+			if (result.size() >= MAX_SESSION_NAME_LENGTH) break;
+			bool allowed = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_' || c == '.';
+			result.push_back(allowed ? c : '_');
+		}
+		while (!result.empty() && result.front() == '.') {
+			result.erase(result.begin());
+		}
+		return result;
+	}
+
+	RefPtr<Session> GetOrCreateSession(const std::string& name, bool persistent) {
+		// The renderer's own default session is stored on disk whenever Config::cache_path is set.
+		// sCachePath is meant for named persistent sessions only, so unnamed views share an in-memory one.
+		if (name.empty() || _stricmp(name.c_str(), "default") == 0) {
+			auto it = sessions.find("");
+			if (it != sessions.end()) return it->second;
+
+			RefPtr<Session> session = renderer->CreateSession(false, String(DEFAULT_SESSION_NAME));
+			if (session) {
+				sessions[""] = session;
+			}
+			else {
+				logger::error("Failed to create the in-memory default session, using the renderer's default session.");
 			}
+			return session;
+		}
 
-			RenderViews();
-			});
+		// Session folders under sCachePath are case-insensitive on Windows, so "MyMod" and "mymod" must
+		// share one Session rather than two writing the same storage.
+		std::string key = name;
+		std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
 
-		std::vector<std::shared_ptr<PrismaView>> viewsToCheck;
-		{
-			std::shared_lock lock(viewsMutex);
-			viewsToCheck.reserve(views.size());
-			for (const auto& pair : views) {
-				if (pair.second && pair.second->ultralightView) {
-					viewsToCheck.push_back(pair.second);
-				}
+		auto it = sessions.find(key);
+		if (it != sessions.end()) {
+			if (it->second->is_persistent() != persistent) {
+				logger::warn("Session '{}' already exists as {}, reusing it.", name, it->second->is_persistent() ? "persistent" : "in-memory");
 			}
+			return it->second;
 		}
 
-		for (const auto& viewData : viewsToCheck) {
-			UpdateSingleTextureFromBuffer(viewData);
+		// sCachePath is only created once something will be stored there.
+		static bool cachePathCreated = false;
+		const auto& cachePath = Settings::Get().ultralight.cachePath;
+		if (persistent && !cachePathCreated && !cachePath.empty()) {
+			std::error_code ec;
+			std::filesystem::create_directories(cachePath, ec);
+			if (ec) {
+				logger::warn("Cannot create cache path {}: {}", cachePath, ec.message());
+			}
+			cachePathCreated = true;
 		}
 
-		DrawViews();
-		DrawCursor();
+		RefPtr<Session> session = renderer->CreateSession(persistent, String(key.c_str()));
+		if (session) {
+			logger::info("Created {} session '{}'.", persistent ? "persistent" : "in-memory", key);
+			sessions[key] = session;
+		}
+		else {
+			logger::error("Failed to create session '{}', using the default session.", name);
+		}
+		return session;
+	}
+
+	bool IsLoadingScreenActive() {
+		auto ui = RE::UI::GetSingleton();
+		return ui && ui->IsMenuOpen(RE::LoadingMenu::MENU_NAME);
 	}
 
 	void Shutdown() {
 		logger::info("Shutting down PrismaUI Core System...");
 
+		HotReload::Stop();
+
 		std::vector<PrismaViewId> viewIdsToDestroy;
 		{
 			std::shared_lock lock(viewsMutex);
@@ -310,11 +437,21 @@ namespace PrismaUI::Core {
 			logicRunner.reset();
 		}
 
+		ioThread.reset();
+
+		ultralightThread.submit([]() {
+			frameCopyWorkers.reset();
+			}).get();
+
 		{
 			std::unique_lock lock(viewsMutex);
 			views.clear();
+			PublishViewSnapshot();
 		}
 		if (renderer) {
+			ultralightThread.submit([]() {
+				sessions.clear();
+				}).get();
 			ultralightThread.submit([renderer_ptr = renderer]() mutable {
 				logger::info("Releasing global renderer on UI thread.");
 				renderer_ptr = nullptr;
@@ -322,7 +459,31 @@ namespace PrismaUI::Core {
 			renderer = nullptr;
 		}
 
+		// Destroy() left the textures of these views to a D3DPresent that will not come anymore.
+		ViewRenderer::ReleaseDeferredViews();
+
+		auto texturePoolStats = ViewRenderer::GetTexturePoolStats();
+		logger::info("Texture pool: {} reuse(s), {} new texture(s), {} evicted.", texturePoolStats.hits, texturePoolStats.misses, texturePoolStats.evictions);
+		ViewRenderer::TrimTexturePool(0);
+
+		auto arenaStats = BufferArena::GetStats();
+		logger::info("Frame buffer arena: {} allocation(s), {} reuse(s), {} failure(s), {} large-page block(s).",
+			arenaStats.allocations, arenaStats.reuses, arenaStats.allocationFailures, arenaStats.largePageBlocks);
+		BufferArena::Trim(0);
+
+		auto ultralightLogStats = Listeners::GetUltralightLogStats();
+		if (ultralightLogStats.errors + ultralightLogStats.warnings > 0) {
+			std::string perCategory;
+			for (size_t i = 0; i < static_cast<size_t>(Listeners::UltralightLogCategory::Count); ++i) {
+				if (ultralightLogStats.categoryCounts[i] == 0) continue;
+				if (!perCategory.empty()) perCategory += ", ";
+				perCategory += std::format("{} {}", Listeners::GetUltralightLogCategoryName(static_cast<Listeners::UltralightLogCategory>(i)), ultralightLogStats.categoryCounts[i]);
+			}
+			logger::info("Ultralight reported {} error(s) and {} warning(s) this session ({}).", ultralightLogStats.errors, ultralightLogStats.warnings, perCategory);
+		}
+
 		coreInitialized = false;
+		DeferredLog::Shutdown();
 		logger::info("PrismaUI Core System shut down complete.");
 	}
 }
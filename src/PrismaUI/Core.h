@@ -9,8 +9,12 @@
 #include <Utils/NanoID.h>
 #include <Utils/SingleThreadExecutor.h>
 #include <Utils/RepeatingTaskRunner.h>
+#include <Utils/WorkerPool.h>
+#include <Utils/BufferArena/BufferArena.h>
 #include <Hooks/Hooks.h>
 #include <Menus/FocusMenu/FocusMenu.h>
+#include <PrismaUI/ViewOperationQueue.h>
+#include <PrismaUI/ViewFrameTable.h>
 
 #include <d3d11.h>
 #include <DirectXTK/SpriteBatch.h>
@@ -24,6 +28,7 @@
 #include <string>
 #include <map>
 #include <queue>
+#include <deque>
 #include <mutex>
 #include <future>
 #include <stdexcept>
@@ -31,6 +36,7 @@
 #include <windowsx.h>
 #include <variant>
 #include <cstdint>
+#include <chrono>
 #include <codecvt>
 
 namespace PrismaUI::Listeners {
@@ -44,41 +50,70 @@ namespace PrismaUI::Core {
 	typedef uint64_t PrismaViewId;
 
 	struct PrismaView {
+		explicit PrismaView(ViewSlot frameSlot);
+
 		PrismaViewId id;
+		// Index of this view's entries in frameTable, see ViewFrameTable.h.
+		const ViewSlot slot;
+
+		// Hot per-frame fields, stored in frameTable.
+		std::atomic<bool>& isHidden;
+		std::atomic<bool>& isHibernated;
+		std::atomic<bool>& newFrameReady;
+		std::atomic<bool>& pendingResourceRelease;
+		std::atomic<int>& queuedOperationsCount;
+		ID3D11Texture2D*& texture;
+		ID3D11ShaderResourceView*& textureView;
+		std::atomic<uint32_t>& textureWidth;
+		std::atomic<uint32_t>& textureHeight;
+		int& order;
+
 		RefPtr<View> ultralightView = nullptr;
+		// Set on the UI thread once ultralightView exists; other threads check this instead of ultralightView.
+		std::atomic<bool> isCreated = false;
 		std::string htmlPathToLoad;
-		std::atomic<bool> isHidden = false;
 		std::unique_ptr<Listeners::MyLoadListener> loadListener;
 		std::unique_ptr<Listeners::MyViewListener> viewListener;
 		std::atomic<bool> isLoadingFinished = false;
 		std::function<void(const PrismaViewId&)> domReadyCallback;
 		int scrollingPixelSize = 28;
 		std::atomic<bool> isPaused = false;
-		int order = 0;
-
-		ID3D11Texture2D* texture = nullptr;
-		ID3D11ShaderResourceView* textureView = nullptr;
-		uint32_t textureWidth = 0;
-		uint32_t textureHeight = 0;
-		std::vector<std::byte> pixelBuffer;
+		std::atomic<bool> isPrewarmed = false;
+		std::atomic<int> creationPriority = 0;
+		std::atomic<bool> prefetchPending = false;
+		// Empty for the renderer's default session.
+		std::string sessionName;
+		bool persistentSession = true;
+
+		BufferArena::Buffer pixelBuffer;
 		uint32_t bufferWidth = 0;
 		uint32_t bufferHeight = 0;
 		uint32_t bufferStride = 0;
 		std::mutex bufferMutex;
-		std::atomic<bool> newFrameReady = false;
-		std::atomic<bool> pendingResourceRelease = false;
+
+		// Memory governor bookkeeping
+		std::atomic<std::chrono::steady_clock::time_point> hiddenSince{};
+		std::atomic<bool> resourcesEvicted = false;
 
 		// Operation queue fields for thread-safe sequential execution
 		std::mutex operationMutex;
-		std::queue<std::function<void()>> pendingOperations;
-		std::atomic<bool> isProcessingOperation = false;
-		std::atomic<int> queuedOperationsCount = 0;
+		ViewOperationQueue::OperationRing pendingOperations;
+
+		// Invoke/InteropCall scripts waiting for the per-frame script budget, see ScriptScheduler
+		std::mutex scriptMutex;
+		std::deque<std::function<void(View*)>> pendingScripts;
+		size_t scriptsCountedAsDeferred = 0;
+		std::atomic<uint32_t> queuedScriptCount = 0;
+		std::atomic<uint64_t> scriptsExecuted = 0;
+		std::atomic<uint64_t> scriptsDeferred = 0;
 
 		~PrismaView();
 	};
 
 	extern SingleThreadExecutor ultralightThread;
 	extern std::unique_ptr<RepeatingTaskRunner> logicRunner;
+	extern std::unique_ptr<WorkerPool> frameCopyWorkers;
+	extern std::unique_ptr<SingleThreadExecutor> ioThread;
 	extern NanoIdGenerator generator;
 	extern std::atomic<bool> coreInitialized;
 
@@ -95,6 +130,30 @@ namespace PrismaUI::Core {
 	extern std::map<PrismaViewId, std::shared_ptr<PrismaView>> views;
 	extern std::shared_mutex viewsMutex;
 
+	// Immutable copy of the views map, republished whenever a view is added, removed or reordered.
+	// Per-frame passes iterate it without taking viewsMutex or copying shared_ptrs.
+	struct ViewSnapshot {
+		// Sorted by id, like the map.
+		std::vector<std::shared_ptr<PrismaView>> views;
+		// frameTable slot of each entry in views.
+		std::vector<ViewSlot> slots;
+		// The same slots back to front (order, then id). Valid as long as the snapshot is held.
+		std::vector<ViewSlot> drawOrder;
+	};
+
+	std::shared_ptr<const ViewSnapshot> GetViewSnapshot();
+	// Rebuilds the snapshot from the views map, viewsMutex must be held exclusively.
+	void PublishViewSnapshot();
+	// Lock-free lookup in the current snapshot, nullptr when the view does not exist.
+	std::shared_ptr<PrismaView> FindView(const PrismaViewId& viewId);
+
+	// Named sessions shared by every view of the same mod, only touched on the UI thread.
+	// Keyed by the lowercased sanitized name. The in-memory session of views created without a
+	// session name is kept under "".
+	extern std::map<std::string, RefPtr<Session>> sessions;
+	constexpr size_t MAX_SESSION_NAME_LENGTH = 64;
+	constexpr const char* DEFAULT_SESSION_NAME = "prismaui_default";
+
 	using SimpleJSCallback = std::function<void(std::string)>;
 
 	struct JSCallbackData {
@@ -113,4 +172,7 @@ namespace PrismaUI::Core {
 	void InitGraphics();
 	void D3DPresent(uint32_t a_p1);
 	void Shutdown();
+	bool IsLoadingScreenActive();
+	std::string SanitizeSessionName(std::string_view name);
+	RefPtr<Session> GetOrCreateSession(const std::string& name, bool persistent);
 }
@@ -0,0 +1,256 @@
+﻿#include "FontCache.h"
+#include "Core.h"
+#include "PackFormat.h"
+
+#include <Utils/Hash.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace PrismaUI::FontCache {
+	using namespace Core;
+
+	static CachingFontLoader* instance = nullptr;
+	static std::atomic<bool> preloadRequested = false;
+
+	static std::string ToLower(std::string text) {
+		for (auto& c : text) {
+			if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+		}
+		return text;
+	}
+
+	static std::string Trim(const std::string& text) {
+		auto begin = text.find_first_not_of(" \t\r\n");
+		if (begin == std::string::npos) return {};
+		auto end = text.find_last_not_of(" \t\r\n");
+		return text.substr(begin, end - begin + 1);
+	}
+
+	static std::string ToStdString(const String& text) {
+		const auto& utf8 = text.utf8();
+		return std::string(utf8.data(), utf8.length());
+	}
+
+	static std::vector<FontFace> ParseManifest(const std::filesystem::path& manifestPath) {
+		std::vector<FontFace> faces;
+		std::ifstream in(manifestPath);
+		if (!in) {
+			logger::warn("FontCache: Cannot read manifest {}", manifestPath.string());
+			return faces;
+		}
+
+		std::string line;
+		FontFace* current = nullptr;
+		while (std::getline(in, line)) {
+			auto comment = line.find_first_of(";#");
+			if (comment != std::string::npos) line.erase(comment);
+			line = Trim(line);
+			if (line.empty()) continue;
+
+			if (line.front() == '[') {
+				faces.emplace_back();
+				current = &faces.back();
+				continue;
+			}
+
+			auto equals = line.find('=');
+			if (!current || equals == std::string::npos) continue;
+
+			std::string key = ToLower(Trim(line.substr(0, equals)));
+			std::string value = Trim(line.substr(equals + 1));
+			if (key == "family") current->family = value;
+			else if (key == "file") current->file = value;
+			else if (key == "weight") current->weight = std::clamp(std::atoi(value.c_str()), 100, 900);
+			else if (key == "italic") current->italic = value == "1" || ToLower(value) == "true";
+			else if (key == "preload") current->preload = value == "1" || ToLower(value) == "true";
+		}
+
+		std::erase_if(faces, [&](const FontFace& face) {
+			if (face.family.empty() || face.file.empty()) {
+				logger::warn("FontCache: {} has a face without family or file, ignored.", manifestPath.string());
+				return true;
+			}
+			return false;
+		});
+		return faces;
+	}
+
+	CachingFontLoader::CachingFontLoader(FontLoader* inner) : inner_(inner) {}
+
+	String CachingFontLoader::fallback_font() const {
+		return inner_->fallback_font();
+	}
+
+	String CachingFontLoader::fallback_font_for_characters(const String& characters, int weight, bool italic) const {
+		return inner_->fallback_font_for_characters(characters, weight, italic);
+	}
+
+	void CachingFontLoader::LoadManifests(const std::string& directory) {
+		std::error_code ec;
+		if (!std::filesystem::is_directory(directory, ec)) return;
+
+		std::vector<std::filesystem::path> manifests;
+		for (const auto& item : std::filesystem::directory_iterator(directory, ec)) {
+			if (item.is_regular_file() && ToLower(item.path().extension().string()) == ".ini") {
+				manifests.push_back(item.path());
+			}
+		}
+		std::sort(manifests.begin(), manifests.end());
+
+		size_t faceCount = 0;
+		std::lock_guard lock(mutex_);
+		for (const auto& manifest : manifests) {
+			for (auto& face : ParseManifest(manifest)) {
+				faces_[ToLower(face.family)].push_back(std::move(face));
+				faceCount++;
+			}
+		}
+
+		logger::info("FontCache: {} font face(s) registered from {} manifest(s).", faceCount, manifests.size());
+	}
+
+	const FontFace* CachingFontLoader::FindFaceLocked(const std::string& family, int weight, bool italic) const {
+		auto it = faces_.find(family);
+		if (it == faces_.end()) return nullptr;
+
+		// Closest weight, preferring the requested style, like CSS font matching does.
+		const FontFace* best = nullptr;
+		int bestScore = INT_MAX;
+		for (const auto& face : it->second) {
+			int score = std::abs(face.weight - weight) + (face.italic != italic ? 1000 : 0);
+			if (score < bestScore) {
+				best = &face;
+				bestScore = score;
+			}
+		}
+		return best;
+	}
+
+	RefPtr<FontFile> CachingFontLoader::LoadFaceFile(const FontFace& face) {
+		std::string key = PackFormat::NormalizePath(face.file);
+		{
+			std::lock_guard lock(mutex_);
+			auto it = filesByPath_.find(key);
+			if (it != filesByPath_.end()) return it->second;
+		}
+
+		// Read through the platform file system so packed and cached fonts work too.
+		FileSystem* fileSystem = Platform::instance().file_system();
+		RefPtr<Buffer> buffer = fileSystem ? fileSystem->OpenFile(String(("Data/" + key).c_str())) : nullptr;
+		if (!buffer) {
+			logger::warn("FontCache: Font file {} for family '{}' not found.", face.file, face.family);
+			return nullptr;
+		}
+
+		uint64_t hash = Fnv1a64(buffer->data(), buffer->size());
+
+		std::lock_guard lock(mutex_);
+		auto [begin, end] = filesByHash_.equal_range(hash);
+		for (auto it = begin; it != end; ++it) {
+			RefPtr<Buffer> existing = it->second->buffer();
+			if (existing && existing->size() == buffer->size() && std::memcmp(existing->data(), buffer->data(), buffer->size()) == 0) {
+				stats_.dedupedFiles++;
+				filesByPath_[key] = it->second;
+				logger::debug("FontCache: {} is identical to an already loaded font, sharing it.", face.file);
+				return it->second;
+			}
+		}
+
+		RefPtr<FontFile> fontFile = FontFile::Create(buffer);
+		filesByHash_.emplace(hash, fontFile);
+		filesByPath_[key] = fontFile;
+		stats_.loadedFiles++;
+		stats_.loadedBytes += buffer->size();
+		return fontFile;
+	}
+
+	RefPtr<FontFile> CachingFontLoader::Load(const String& family, int weight, bool italic) {
+		LookupKey key{ ToLower(ToStdString(family)), weight, italic };
+
+		FontFace face;
+		bool hasFace = false;
+		{
+			std::lock_guard lock(mutex_);
+			stats_.lookups++;
+			auto it = lookups_.find(key);
+			if (it != lookups_.end()) {
+				stats_.lookupHits++;
+				return it->second;
+			}
+
+			if (const FontFace* found = FindFaceLocked(std::get<0>(key), weight, italic)) {
+				face = *found;
+				hasFace = true;
+			}
+		}
+
+		RefPtr<FontFile> result = hasFace ? LoadFaceFile(face) : nullptr;
+		if (!result) {
+			result = inner_->Load(family, weight, italic);
+		}
+
+		std::lock_guard lock(mutex_);
+		lookups_[key] = result;
+		return result;
+	}
+
+	void CachingFontLoader::Preload() {
+		std::vector<FontFace> toPreload;
+		{
+			std::lock_guard lock(mutex_);
+			for (const auto& [family, familyFaces] : faces_) {
+				for (const auto& face : familyFaces) {
+					if (face.preload) toPreload.push_back(face);
+				}
+			}
+		}
+
+		if (toPreload.empty()) return;
+
+		auto start = std::chrono::steady_clock::now();
+		size_t loaded = 0;
+		for (const auto& face : toPreload) {
+			if (LoadFaceFile(face)) loaded++;
+		}
+
+		double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		logger::info("FontCache: Preloaded {} of {} font face(s) in {:.2f} ms.", loaded, toPreload.size(), elapsedMs);
+	}
+
+	FontCacheStats CachingFontLoader::GetStats() {
+		std::lock_guard lock(mutex_);
+		return stats_;
+	}
+
+	FontLoader* Install(FontLoader* inner) {
+		instance = new CachingFontLoader(inner);
+		instance->LoadManifests(MANIFEST_DIRECTORY);
+		return instance;
+	}
+
+	CachingFontLoader* Get() {
+		return instance;
+	}
+
+	void RequestPreload() {
+		if (!instance || !ioThread || preloadRequested.exchange(true)) return;
+
+		try {
+			ioThread->submit([]() {
+				try {
+					instance->Preload();
+				}
+				catch (const std::exception& e) {
+					logger::warn("FontCache: Preload failed: {}", e.what());
+				}
+				});
+		}
+		catch (const std::exception& e) {
+			logger::warn("FontCache: Cannot queue preload: {}", e.what());
+		}
+	}
+}
@@ -0,0 +1,88 @@
+﻿#pragma once
+
+#include <Ultralight/Ultralight.h>
+#include <Ultralight/platform/FontLoader.h>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace PrismaUI::FontCache {
+	using namespace ultralight;
+
+	constexpr auto MANIFEST_DIRECTORY = "Data/PrismaUI/fonts";
+
+	// A font face declared by a mod in Data/PrismaUI/fonts/*.ini:
+	//
+	//   [Inter Bold]
+	//   family = Inter
+	//   file = PrismaUI/views/MyMod/fonts/Inter-Bold.ttf   ; relative to Data, may be packed
+	//   weight = 700
+	//   italic = 0
+	//   preload = 1
+	struct FontFace {
+		std::string family;
+		std::string file;
+		int weight = 400;
+		bool italic = false;
+		bool preload = false;
+	};
+
+	struct FontCacheStats {
+		uint32_t lookups = 0;
+		uint32_t lookupHits = 0;
+		uint32_t loadedFiles = 0;
+		uint32_t dedupedFiles = 0;
+		uint64_t loadedBytes = 0;
+	};
+
+	// FontLoader shared by all views. Lookups are memoized, faces from mod manifests are served
+	// from memory, and identical font files are loaded once no matter how many mods ship them.
+	// Everything else falls through to the platform font loader.
+	class CachingFontLoader : public FontLoader {
+	public:
+		explicit CachingFontLoader(FontLoader* inner);
+		virtual ~CachingFontLoader() = default;
+
+		CachingFontLoader(const CachingFontLoader&) = delete;
+		CachingFontLoader& operator=(const CachingFontLoader&) = delete;
+
+		virtual String fallback_font() const override;
+		virtual String fallback_font_for_characters(const String& characters, int weight, bool italic) const override;
+		virtual RefPtr<FontFile> Load(const String& family, int weight, bool italic) override;
+
+		void LoadManifests(const std::string& directory);
+
+		// Reads every manifest face marked preload into memory. Safe to call from any thread.
+		void Preload();
+
+		FontCacheStats GetStats();
+
+	private:
+		using LookupKey = std::tuple<std::string, int, bool>;
+
+		const FontFace* FindFaceLocked(const std::string& family, int weight, bool italic) const;
+		RefPtr<FontFile> LoadFaceFile(const FontFace& face);
+
+		FontLoader* inner_;
+
+		std::mutex mutex_;
+		std::unordered_map<std::string, std::vector<FontFace>> faces_;
+		std::map<LookupKey, RefPtr<FontFile>> lookups_;
+		std::unordered_map<std::string, RefPtr<FontFile>> filesByPath_;
+		std::unordered_multimap<uint64_t, RefPtr<FontFile>> filesByHash_;
+		FontCacheStats stats_;
+	};
+
+	FontLoader* Install(FontLoader* inner);
+	CachingFontLoader* Get();
+
+	// Queues a one-time preload of manifest fonts on the I/O thread. Called while a loading
+	// screen is up so file reads never land on a frame the player sees.
+	void RequestPreload();
+}
@@ -0,0 +1,237 @@
+﻿#include "HotReload.h"
+#include "Core.h"
+#include "Settings.h"
+#include "CachingFileSystem.h"
+#include "AssetPrefetcher.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <set>
+#include <thread>
+
+namespace PrismaUI::HotReload {
+	using namespace Core;
+	using Clock = std::chrono::steady_clock;
+
+	// Re-requests every stylesheet with a cache-busting query, the page keeps its state.
+	static constexpr auto RELOAD_STYLESHEETS_SCRIPT =
+		"document.querySelectorAll('link[rel=\"stylesheet\"]').forEach(function(link) {"
+		"  var url = new URL(link.href, document.baseURI);"
+		"  url.searchParams.set('prismaReload', Date.now());"
+		"  link.href = url.href;"
+		"});";
+
+	constexpr DWORD NOTIFY_BUFFER_BYTES = 64 * 1024;
+
+	// Folder key of files directly in VIEWS_DIRECTORY, they only affect views loaded from there.
+	static constexpr auto TOP_LEVEL_FOLDER = "";
+
+	static std::atomic<bool> watching = false;
+	static HANDLE stopEvent = nullptr;
+	// Signalled by the watcher thread right before it returns.
+	static HANDLE stoppedEvent = nullptr;
+
+	struct FolderChanges {
+		std::set<std::string> files;
+		bool onlyStylesheets = true;
+	};
+
+	static std::string ToLower(std::string text) {
+		std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+		return text;
+	}
+
+	static std::string ToUtf8(const wchar_t* text, size_t length) {
+		int size = WideCharToMultiByte(CP_UTF8, 0, text, static_cast<int>(length), nullptr, 0, nullptr, nullptr);
+		std::string result(size > 0 ? size : 0, '\0');
+		if (size > 0) {
+			WideCharToMultiByte(CP_UTF8, 0, text, static_cast<int>(length), result.data(), size, nullptr, nullptr);
+		}
+		return result;
+	}
+
+	// Path relative to VIEWS_DIRECTORY, e.g. "MyMod/css/main.css" or "index.html".
+	static void CollectChange(std::map<std::string, FolderChanges>& batch, std::string relativePath) {
+		std::replace(relativePath.begin(), relativePath.end(), '\\', '/');
+
+		size_t separator = relativePath.find('/');
+		std::string key;
+		if (separator != std::string::npos) {
+			key = ToLower(relativePath.substr(0, separator));
+		}
+		else {
+			// A folder created or renamed directly in VIEWS_DIRECTORY belongs to itself, not to the top level.
+			std::error_code ec;
+			bool isFolder = std::filesystem::is_directory(std::filesystem::path(VIEWS_DIRECTORY) / std::filesystem::u8path(relativePath), ec);
+			key = isFolder ? ToLower(relativePath) : std::string(TOP_LEVEL_FOLDER);
+		}
+
+		auto& folder = batch[key];
+		if (!ToLower(relativePath).ends_with(".css")) {
+			folder.onlyStylesheets = false;
+		}
+		folder.files.insert(std::move(relativePath));
+	}
+
+	// Folder of a view's current URL under VIEWS_DIRECTORY, nullopt for URLs elsewhere.
+	static std::optional<std::string> ViewFolder(const std::string& url) {
+		std::string_view prefix = VIEW_URL_PREFIX;
+		if (!url.starts_with(prefix)) return std::nullopt;
+
+		// URLs are percent-encoded, folder names on disk are not ("My%20Mod" is the folder "My Mod").
+		std::string_view path = std::string_view(url).substr(prefix.size());
+		path = path.substr(0, path.find_first_of("?#"));
+		std::string relative = AssetPrefetcher::PercentDecode(path);
+		std::replace(relative.begin(), relative.end(), '\\', '/');
+		size_t separator = relative.find('/');
+		return separator == std::string::npos ? std::string(TOP_LEVEL_FOLDER) : ToLower(relative.substr(0, separator));
+	}
+
+	static void ApplyBatch(std::map<std::string, FolderChanges> batch) {
+		if (auto cache = CachingFileSystem::Get()) {
+			for (const auto& [folder, changes] : batch) {
+				for (const auto& file : changes.files) {
+					cache->Invalidate(std::string(VIEWS_DIRECTORY) + "/" + file);
+				}
+			}
+		}
+
+		ultralightThread.submit_ordered(TaskPriority::Background, SingleThreadExecutor::ALL_ORDER_KEYS, [batch = std::move(batch)]() {
+			const auto snapshot = GetViewSnapshot();
+			for (const auto& viewData : snapshot->views) {
+				if (!viewData->ultralightView) continue;
+
+				// The current URL rather than htmlPathToLoad, which is cleared once the view is created.
+				auto folder = ViewFolder(std::string(viewData->ultralightView->url().utf8().data()));
+				if (!folder) continue;
+
+				auto it = batch.find(*folder);
+				if (it == batch.end()) continue;
+
+				if (it->second.onlyStylesheets) {
+					logger::info("HotReload: Reloading stylesheets of View [{}] ({} file(s) changed in '{}').", viewData->id, it->second.files.size(), it->first);
+					viewData->ultralightView->EvaluateScript(RELOAD_STYLESHEETS_SCRIPT, nullptr, "");
+				}
+				else {
+					logger::info("HotReload: Reloading View [{}] ({} file(s) changed in '{}').", viewData->id, it->second.files.size(), it->first);
+					viewData->ultralightView->Reload();
+				}
+			}
+			});
+	}
+
+	static void WatchLoop(HANDLE directory, Clock::duration debounce) {
+		OVERLAPPED overlapped{};
+		overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+		alignas(DWORD) static std::byte buffer[NOTIFY_BUFFER_BYTES];
+
+		const DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+
+		std::map<std::string, FolderChanges> batch;
+		Clock::time_point lastChange{};
+
+		while (true) {
+			ResetEvent(overlapped.hEvent);
+			if (!ReadDirectoryChangesW(directory, buffer, NOTIFY_BUFFER_BYTES, TRUE, filter, nullptr, &overlapped, nullptr)) {
+				logger::error("HotReload: Watching {} failed (error {}), hot reload stopped.", VIEWS_DIRECTORY, GetLastError());
+				break;
+			}
+
+			bool stopping = false;
+			while (true) {
+				DWORD timeout = INFINITE;
+				if (!batch.empty()) {
+					auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(lastChange + debounce - Clock::now());
+					timeout = static_cast<DWORD>(std::max<int64_t>(remaining.count(), 0));
+				}
+
+				HANDLE handles[] = { overlapped.hEvent, stopEvent };
+				DWORD result = WaitForMultipleObjects(2, handles, FALSE, timeout);
+
+				if (result != WAIT_OBJECT_0 && result != WAIT_TIMEOUT) {
+					if (result != WAIT_OBJECT_0 + 1) {
+						logger::error("HotReload: Waiting for changes failed (error {}), hot reload stopped.", GetLastError());
+					}
+					stopping = true;
+					break;
+				}
+
+				if (result == WAIT_TIMEOUT) {
+					ApplyBatch(std::move(batch));
+					batch.clear();
+					continue;
+				}
+
+				DWORD bytes = 0;
+				if (!GetOverlappedResult(directory, &overlapped, &bytes, FALSE)) {
+					logger::error("HotReload: Reading changes failed (error {}), hot reload stopped.", GetLastError());
+					stopping = true;
+					break;
+				}
+
+				if (bytes == 0) {
+					// The notification buffer overflowed, the changes themselves are lost.
+					logger::warn("HotReload: Too many changes at once, some may have been missed.");
+				}
+
+				for (size_t offset = 0; bytes != 0;) {
+					auto* info = reinterpret_cast<FILE_NOTIFY_INFORMATION*>(buffer + offset);
+					CollectChange(batch, ToUtf8(info->FileName, info->FileNameLength / sizeof(wchar_t)));
+					if (info->NextEntryOffset == 0) break;
+					offset += info->NextEntryOffset;
+				}
+				lastChange = Clock::now();
+				break;
+			}
+
+			if (stopping) {
+				DWORD ignored = 0;
+				CancelIo(directory);
+				GetOverlappedResult(directory, &overlapped, &ignored, TRUE);
+				break;
+			}
+		}
+
+		CloseHandle(overlapped.hEvent);
+		CloseHandle(directory);
+		watching = false;
+		SetEvent(stoppedEvent);
+	}
+
+	void Start() {
+		const auto& developer = Settings::Get().developer;
+		if (!developer.hotReload || watching) return;
+
+		HANDLE directory = CreateFileA(VIEWS_DIRECTORY, FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+		if (directory == INVALID_HANDLE_VALUE) {
+			logger::error("HotReload: Cannot open {} (error {}), hot reload disabled.", VIEWS_DIRECTORY, GetLastError());
+			return;
+		}
+
+		// Both events live until the process exits, a detached watcher may still be waiting on them.
+		if (!stopEvent) stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+		if (!stoppedEvent) stoppedEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+		ResetEvent(stopEvent);
+		ResetEvent(stoppedEvent);
+
+		auto debounce = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(developer.hotReloadDebounceMs));
+		watching = true;
+		// Detached so a missing Shutdown() on process exit cannot terminate() in a static std::thread destructor.
+		std::thread(WatchLoop, directory, debounce).detach();
+		logger::info("HotReload: Watching {} for changes (developer mode).", VIEWS_DIRECTORY);
+	}
+
+	void Stop() {
+		if (!watching) return;
+
+		SetEvent(stopEvent);
+		if (WaitForSingleObject(stoppedEvent, 1000) != WAIT_OBJECT_0) {
+			logger::warn("HotReload: Watcher thread did not stop in time.");
+		}
+	}
+}
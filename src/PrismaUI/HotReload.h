@@ -0,0 +1,14 @@
+﻿#pragma once
+
+namespace PrismaUI::HotReload {
+	constexpr auto VIEWS_DIRECTORY = "Data/PrismaUI/views";
+	constexpr auto VIEW_URL_PREFIX = "file:///Data/PrismaUI/views/";
+
+	// Developer mode: watches Data/PrismaUI/views and reloads the views whose folder changed.
+	// Views only touched by .css changes get their stylesheets swapped instead of a full reload.
+	// A view's folder is the first folder of its URL below views/; files directly in views/ only
+	// reload views loaded from there, so shared files at that level do not reload views in subfolders.
+	// Does nothing unless [Developer] bHotReload is set, no watcher thread exists then.
+	void Start();
+	void Stop();
+}
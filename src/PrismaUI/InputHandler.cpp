@@ -220,7 +220,7 @@ namespace PrismaUI::InputHandler {
                 g_mouseButtonStates[0] = g_mouseButtonStates[1] = g_mouseButtonStates[2] = false;
 
                 if (g_ultralightThreadExecutor && currentFocusedBeforeDisable != 0) {
-                    g_ultralightThreadExecutor->submit([viewId_copy = currentFocusedBeforeDisable]() {
+                    g_ultralightThreadExecutor->submit_ordered(TaskPriority::Input, currentFocusedBeforeDisable, [viewId_copy = currentFocusedBeforeDisable]() {
                         std::shared_ptr<Core::PrismaView> targetViewData = nullptr;
                         {
                             std::shared_lock lock(*g_viewsMapMutex);
@@ -381,7 +381,8 @@ namespace PrismaUI::InputHandler {
             eventsToProcess.swap(g_eventQueue);
         }
 
-        g_ultralightThreadExecutor->submit([viewId_copy = focusedViewIdCopy, ev_queue = std::move(eventsToProcess)]() {
+        // Keyed by the view, so the events wait for operations queued on it before them (Hide, Unfocus, Destroy).
+        g_ultralightThreadExecutor->submit_ordered(TaskPriority::Input, focusedViewIdCopy, [viewId_copy = focusedViewIdCopy, ev_queue = std::move(eventsToProcess)]() {
             std::shared_ptr<Core::PrismaView> targetViewData = nullptr;
             {
                 std::shared_lock lock(*g_viewsMapMutex);
@@ -1,6 +1,14 @@
 ﻿#include "Listeners.h"
 #include "Core.h"
 #include "Communication.h"
+#include "ConsoleRouter.h"
+#include "Settings.h"
+
+#include <Utils/DeferredLog/DeferredLog.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
 
 namespace PrismaUI::Listeners {
 	using namespace Core;
@@ -13,7 +21,7 @@ namespace PrismaUI::Listeners {
 
 	void MyLoadListener::OnBeginLoading(View* caller, uint64_t frame_id, bool is_main_frame, const String& url) {
 		logger::info("View [{}]: LoadListener: Begin loading URL: {}", viewId_, url.utf8().data());
-		ultralightThread.submit([id = viewId_] {
+		ultralightThread.submit_ordered(TaskPriority::Render, viewId_, [id = viewId_] {
 			std::shared_lock lock(viewsMutex);
 			auto it = views.find(id);
 			if (it != views.end()) {
@@ -24,7 +32,7 @@ namespace PrismaUI::Listeners {
 
 	void MyLoadListener::OnFinishLoading(View* caller, uint64_t frame_id, bool is_main_frame, const String& url) {
 		logger::info("View [{}]: LoadListener: Finished loading URL: {}", viewId_, url.utf8().data());
-		ultralightThread.submit([id = viewId_] {
+		ultralightThread.submit_ordered(TaskPriority::Render, viewId_, [id = viewId_] {
 			std::shared_lock lock(viewsMutex);
 			auto it = views.find(id);
 			if (it != views.end()) {
@@ -36,7 +44,7 @@ namespace PrismaUI::Listeners {
 
 	void MyLoadListener::OnFailLoading(View* caller, uint64_t frame_id, bool is_main_frame, const String& url, const String& description, const String& error_domain, int error_code) {
 		logger::error("View [{}]: LoadListener: Failed loading URL: {}. Error: {}", viewId_, url.utf8().data(), description.utf8().data());
-		ultralightThread.submit([id = viewId_] {
+		ultralightThread.submit_ordered(TaskPriority::Render, viewId_, [id = viewId_] {
 			std::shared_lock lock(viewsMutex);
 			auto it = views.find(id);
 			if (it != views.end()) {
@@ -51,7 +59,7 @@ namespace PrismaUI::Listeners {
 
 	void MyLoadListener::OnDOMReady(View* caller, uint64_t frame_id, bool is_main_frame, const String& url) {
 		logger::info("View [{}]: LoadListener: DOM ready.", viewId_);
-		ultralightThread.submit([id = viewId_] {
+		ultralightThread.submit_ordered(TaskPriority::Render, viewId_, [id = viewId_] {
 			std::shared_lock lock(viewsMutex);
 			auto it = views.find(id);
 			if (it != views.end() && it->second->domReadyCallback) {
@@ -66,13 +74,81 @@ namespace PrismaUI::Listeners {
 	MyViewListener::~MyViewListener() = default;
 
 	void MyViewListener::OnAddConsoleMessage(View* caller, const ConsoleMessage& message) {
-		logger::info("View [{}]: JSConsole: {}", viewId_, message.message().utf8().data());
+		ConsoleRouter::Route(viewId_, message);
 	}
 
 	// MyUltralightLogger
 	MyUltralightLogger::~MyUltralightLogger() = default;
 
+	static constexpr size_t CATEGORY_COUNT = static_cast<size_t>(UltralightLogCategory::Count);
+	static const char* CATEGORY_NAMES[CATEGORY_COUNT] = { "Resource", "Memory", "Font", "Graphics", "Script", "Other" };
+
+	static std::atomic<uint64_t> ultralightErrorCount = 0;
+	static std::atomic<uint64_t> ultralightWarningCount = 0;
+	static std::atomic<uint64_t> ultralightInfoCount = 0;
+	static std::array<std::atomic<uint64_t>, CATEGORY_COUNT> ultralightCategoryCounts{};
+
+	static UltralightLogCategory ClassifyUltralightMessage(std::string text) {
+		std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(tolower(c)); });
+
+		auto contains = [&text](std::initializer_list<const char*> keywords) {
+			return std::any_of(keywords.begin(), keywords.end(), [&text](const char* keyword) {
+				return text.find(keyword) != std::string::npos;
+				});
+		};
+
+		if (contains({ "memory", "alloc", "heap", "out of mem" })) return UltralightLogCategory::Memory;
+		if (contains({ "font", "glyph" })) return UltralightLogCategory::Font;
+		if (contains({ "gpu", "bitmap", "texture", "surface", "render" })) return UltralightLogCategory::Graphics;
+		if (contains({ "javascript", "script", "jsc" })) return UltralightLogCategory::Script;
+		if (contains({ "load", "resource", "file", "url", "network", "http" })) return UltralightLogCategory::Resource;
+		return UltralightLogCategory::Other;
+	}
+
 	void MyUltralightLogger::LogMessage(LogLevel log_level, const String& message) {
-		// Implementation was empty, so keep it empty.
+		DeferredLog::Level level;
+		switch (log_level) {
+		case LogLevel::Error:
+			level = DeferredLog::Level::Error;
+			ultralightErrorCount.fetch_add(1, std::memory_order_relaxed);
+			break;
+		case LogLevel::Warning:
+			level = DeferredLog::Level::Warn;
+			ultralightWarningCount.fetch_add(1, std::memory_order_relaxed);
+			break;
+		default:
+			level = DeferredLog::Level::Info;
+			ultralightInfoCount.fetch_add(1, std::memory_order_relaxed);
+			break;
+		}
+
+		bool counted = level >= DeferredLog::Level::Warn;
+		bool logged = level >= Settings::Get().logging.ultralightLevel && DeferredLog::IsEnabled(level);
+		if (!counted && !logged) return;
+
+		std::string text = message.utf8().data();
+		UltralightLogCategory category = ClassifyUltralightMessage(text);
+		if (counted) {
+			ultralightCategoryCounts[static_cast<size_t>(category)].fetch_add(1, std::memory_order_relaxed);
+		}
+		if (logged) {
+			DeferredLog::log(level, "Ultralight [{}]: {}", CATEGORY_NAMES[static_cast<size_t>(category)], text);
+		}
+	}
+
+	const char* GetUltralightLogCategoryName(UltralightLogCategory category) {
+		size_t index = static_cast<size_t>(category);
+		return index < CATEGORY_COUNT ? CATEGORY_NAMES[index] : "Unknown";
+	}
+
+	UltralightLogStats GetUltralightLogStats() {
+		UltralightLogStats stats;
+		stats.errors = ultralightErrorCount.load(std::memory_order_relaxed);
+		stats.warnings = ultralightWarningCount.load(std::memory_order_relaxed);
+		stats.infos = ultralightInfoCount.load(std::memory_order_relaxed);
+		for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+			stats.categoryCounts[i] = ultralightCategoryCounts[i].load(std::memory_order_relaxed);
+		}
+		return stats;
 	}
 }
@@ -37,9 +37,32 @@ namespace PrismaUI::Listeners {
 		virtual void OnAddConsoleMessage(View* caller, const ConsoleMessage& message) override;
 	};
 
+	// Rough origin of an Ultralight log message, guessed from its text.
+	enum class UltralightLogCategory : uint8_t {
+		Resource,
+		Memory,
+		Font,
+		Graphics,
+		Script,
+		Other,
+		Count
+	};
+
+	struct UltralightLogStats {
+		uint64_t errors = 0;
+		uint64_t warnings = 0;
+		uint64_t infos = 0;
+		// Errors and warnings per UltralightLogCategory.
+		uint64_t categoryCounts[static_cast<size_t>(UltralightLogCategory::Count)] = {};
+	};
+
+	// Forwards renderer-internal messages to the deferred log. Ultralight may call it from any of its threads.
 	class MyUltralightLogger : public Logger {
 	public:
 		virtual ~MyUltralightLogger();
 		virtual void LogMessage(LogLevel log_level, const String& message) override;
 	};
+
+	const char* GetUltralightLogCategoryName(UltralightLogCategory category);
+	UltralightLogStats GetUltralightLogStats();
 }
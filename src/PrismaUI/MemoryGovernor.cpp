@@ -0,0 +1,218 @@
+﻿#include "MemoryGovernor.h"
+#include "Core.h"
+#include "Settings.h"
+#include "ViewRenderer.h"
+#include "ViewManager.h"
+
+#include <algorithm>
+
+namespace PrismaUI::MemoryGovernor {
+	using namespace Core;
+	using Clock = std::chrono::steady_clock;
+
+	static std::mutex statsMutex;
+	static MemoryStats lastStats;
+
+	static Clock::time_point lastTick{};
+	static Clock::time_point lastPurge{};
+	static bool wasLoadingScreenActive = false;
+	static std::atomic<uint32_t> purgeCount = 0;
+
+	// Memory-pressure purges while over budget. Another purge only follows if the last one brought
+	// the total down; otherwise the retry interval doubles, so a budget that frame memory alone
+	// exceeds does not purge the renderer every cooldown forever.
+	constexpr auto MAX_PRESSURE_PURGE_INTERVAL = std::chrono::minutes(5);
+	static uint64_t pressurePurgeTotal = 0;
+	static Clock::duration pressurePurgeInterval{};
+	static Clock::time_point nextPressurePurge{};
+
+	static ViewMemoryUsage MeasureView(PrismaView* viewData) {
+		ViewMemoryUsage usage;
+		if (!viewData) return usage;
+
+		{
+			std::lock_guard lock(viewData->bufferMutex);
+			usage.cpuBytes = viewData->pixelBuffer.capacity();
+		}
+		usage.gpuBytes = static_cast<uint64_t>(viewData->textureWidth.load()) * viewData->textureHeight.load() * 4;
+		usage.evicted = viewData->resourcesEvicted.load();
+		return usage;
+	}
+
+	void EvictViewResources(const std::shared_ptr<PrismaView>& viewData) {
+		if (!viewData) return;
+
+		logger::debug("MemoryGovernor: Evicting frame resources of hidden View [{}]", viewData->id);
+
+		ViewRenderer::ReleaseViewTexture(viewData.get());
+		viewData->newFrameReady = false;
+
+		// Keyed by the view so it stays behind earlier operations on it; a Show queued meanwhile keeps the buffer.
+		ultralightThread.submit_ordered(TaskPriority::Background, viewData->id, [viewData]() {
+			if (!viewData->isHidden.load()) {
+				// The texture is already gone, so the current frame still has to be copied again.
+				logger::debug("MemoryGovernor: View [{}] was shown again, pixel buffer kept.", viewData->id);
+				viewData->resourcesEvicted = true;
+				return;
+			}
+			{
+				std::lock_guard lock(viewData->bufferMutex);
+				viewData->pixelBuffer.release();
+				viewData->bufferWidth = 0;
+				viewData->bufferHeight = 0;
+				viewData->bufferStride = 0;
+			}
+			viewData->newFrameReady = false;
+			viewData->resourcesEvicted = true;
+			});
+	}
+
+	void RequestPurge(const char* reason) {
+		auto now = Clock::now();
+		auto cooldown = std::chrono::duration<double>(Settings::Get().memory.purgeCooldownSeconds);
+		if (lastPurge != Clock::time_point{} && now - lastPurge < cooldown) {
+			return;
+		}
+		lastPurge = now;
+		purgeCount.fetch_add(1, std::memory_order_relaxed);
+
+		logger::info("MemoryGovernor: Purging renderer memory ({}).", reason);
+		ViewRenderer::TrimTexturePool(0);
+		BufferArena::Trim(0);
+		ultralightThread.submit(TaskPriority::Background, []() {
+			if (renderer) {
+				renderer->PurgeMemory();
+				renderer->LogMemoryUsage();
+			}
+			});
+	}
+
+	void Tick() {
+		auto now = Clock::now();
+		if (now - lastTick < TICK_INTERVAL) return;
+		lastTick = now;
+
+		const auto& memorySettings = Settings::Get().memory;
+
+		bool loadingScreenActive = IsLoadingScreenActive();
+		if (loadingScreenActive && !wasLoadingScreenActive && memorySettings.purgeOnLoadingScreen) {
+			RequestPurge("loading screen");
+		}
+		wasLoadingScreenActive = loadingScreenActive;
+
+		const auto snapshot = GetViewSnapshot();
+		const auto& viewsToMeasure = snapshot->views;
+
+		MemoryStats stats;
+		stats.budgetBytes = memorySettings.budgetBytes;
+		stats.viewCount = static_cast<uint32_t>(viewsToMeasure.size());
+
+		struct EvictionCandidate {
+			std::shared_ptr<PrismaView> viewData;
+			Clock::time_point hiddenSince;
+			uint64_t bytes;
+		};
+		std::vector<EvictionCandidate> candidates;
+
+		auto evictAfter = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(memorySettings.evictHiddenAfterSeconds));
+		const double autoHibernateSeconds = Settings::Get().views.autoHibernateAfterSeconds;
+		auto hibernateAfter = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(autoHibernateSeconds));
+
+		for (const auto& viewData : viewsToMeasure) {
+			ViewMemoryUsage usage = MeasureView(viewData.get());
+			stats.cpuBytes += usage.cpuBytes;
+			stats.gpuBytes += usage.gpuBytes;
+			if (usage.evicted) stats.evictedViewCount++;
+
+			bool hibernated = viewData->isHibernated.load();
+			if (hibernated) stats.hibernatedViewCount++;
+
+			if (!viewData->isHidden.load()) continue;
+
+			Clock::time_point hiddenSince = viewData->hiddenSince.load();
+			if (!hibernated && autoHibernateSeconds > 0.0 && viewData->isCreated.load() && now - hiddenSince >= hibernateAfter) {
+				ViewManager::Hibernate(viewData->id);
+			}
+
+			uint64_t bytes = usage.cpuBytes + usage.gpuBytes;
+			if (bytes == 0 || viewData->pendingResourceRelease.load()) continue;
+
+			if (hibernated || now - hiddenSince >= evictAfter) {
+				EvictViewResources(viewData);
+				stats.cpuBytes -= usage.cpuBytes;
+				stats.gpuBytes -= usage.gpuBytes;
+				stats.evictedViewCount++;
+			}
+			else {
+				candidates.push_back({ viewData, hiddenSince, bytes });
+			}
+		}
+
+		// Idle pooled textures are GPU memory like any view texture and count towards the budget.
+		uint64_t pooledBytes = ViewRenderer::GetTexturePoolStats().pooledBytes;
+		stats.gpuBytes += pooledBytes;
+
+		if (stats.budgetBytes > 0 && stats.cpuBytes + stats.gpuBytes > stats.budgetBytes) {
+			uint64_t total = stats.cpuBytes + stats.gpuBytes;
+
+			// Nothing is drawing from the pool, so it is trimmed before any view loses its frame.
+			uint64_t excess = total - stats.budgetBytes;
+			uint64_t keepPooled = pooledBytes > excess ? pooledBytes - excess : 0;
+			ViewRenderer::TrimTexturePool(keepPooled);
+			uint64_t trimmedBytes = pooledBytes - std::min(pooledBytes, ViewRenderer::GetTexturePoolStats().pooledBytes);
+			stats.gpuBytes -= trimmedBytes;
+			total -= trimmedBytes;
+
+			std::sort(candidates.begin(), candidates.end(), [](const EvictionCandidate& a, const EvictionCandidate& b) {
+				return a.hiddenSince < b.hiddenSince;
+			});
+
+			for (const auto& candidate : candidates) {
+				if (total <= stats.budgetBytes) break;
+				EvictViewResources(candidate.viewData);
+				total -= candidate.bytes;
+				stats.evictedViewCount++;
+			}
+
+			if (total > stats.budgetBytes) {
+				bool purgeHelped = pressurePurgeTotal == 0 || total < pressurePurgeTotal;
+				if (purgeHelped || now >= nextPressurePurge) {
+					logger::warn("MemoryGovernor: PrismaUI frame memory {} MB exceeds budget {} MB.", total / (1024 * 1024), stats.budgetBytes / (1024 * 1024));
+					RequestPurge("memory pressure");
+
+					auto cooldown = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(memorySettings.purgeCooldownSeconds));
+					pressurePurgeInterval = purgeHelped ? cooldown : std::min<Clock::duration>(pressurePurgeInterval * 2, MAX_PRESSURE_PURGE_INTERVAL);
+					nextPressurePurge = now + pressurePurgeInterval;
+					pressurePurgeTotal = total;
+				}
+			}
+			else {
+				pressurePurgeTotal = 0;
+			}
+		}
+		else {
+			pressurePurgeTotal = 0;
+		}
+
+		stats.purgeCount = purgeCount.load(std::memory_order_relaxed);
+
+		std::lock_guard lock(statsMutex);
+		lastStats = stats;
+	}
+
+	ViewMemoryUsage GetViewUsage(const Core::PrismaViewId& viewId) {
+		std::shared_ptr<PrismaView> viewData = FindView(viewId);
+
+		if (!viewData) {
+			logger::warn("GetViewUsage: View ID [{}] not found.", viewId);
+			return {};
+		}
+
+		return MeasureView(viewData.get());
+	}
+
+	MemoryStats GetStats() {
+		std::lock_guard lock(statsMutex);
+		return lastStats;
+	}
+}
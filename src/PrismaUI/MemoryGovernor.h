@@ -0,0 +1,43 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <chrono>
+#include <memory>
+
+namespace PrismaUI::Core {
+	typedef uint64_t PrismaViewId;
+	struct PrismaView;
+}
+
+namespace PrismaUI::MemoryGovernor {
+	// How often the render thread re-evaluates memory usage.
+	constexpr auto TICK_INTERVAL = std::chrono::milliseconds(500);
+
+	struct ViewMemoryUsage {
+		uint64_t cpuBytes = 0;
+		uint64_t gpuBytes = 0;
+		bool evicted = false;
+	};
+
+	struct MemoryStats {
+		uint64_t cpuBytes = 0;
+		uint64_t gpuBytes = 0;
+		uint64_t budgetBytes = 0;
+		uint32_t viewCount = 0;
+		uint32_t evictedViewCount = 0;
+		uint32_t hibernatedViewCount = 0;
+		uint32_t purgeCount = 0;
+	};
+
+	// Called from D3DPresent on the render thread.
+	void Tick();
+
+	// Releases the texture (render thread) and pixel buffer (UI thread) of a view.
+	// The next frame copy after the view is shown again rebuilds both.
+	void EvictViewResources(const std::shared_ptr<Core::PrismaView>& viewData);
+
+	void RequestPurge(const char* reason);
+
+	ViewMemoryUsage GetViewUsage(const Core::PrismaViewId& viewId);
+	MemoryStats GetStats();
+}
@@ -0,0 +1,177 @@
+﻿#include "PackFileSystem.h"
+#include "PackFormat.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+namespace PrismaUI::PackFileSystem {
+	PackFileSystem::PackFileSystem(FileSystem* looseFileSystem) : looseFileSystem_(looseFileSystem) {}
+
+	PackFileSystem::~PackFileSystem() {
+		entries_.clear();
+		for (auto& pack : packs_) {
+			Unmap(pack);
+		}
+	}
+
+	void PackFileSystem::Unmap(MappedPack& pack) {
+		if (pack.view) UnmapViewOfFile(pack.view);
+		if (pack.mapping) CloseHandle(pack.mapping);
+		if (pack.file != INVALID_HANDLE_VALUE) CloseHandle(pack.file);
+		pack = MappedPack{};
+	}
+
+	void PackFileSystem::MountDirectory(const std::string& directory) {
+		std::error_code ec;
+		if (!std::filesystem::is_directory(directory, ec)) {
+			logger::debug("PackFileSystem: No pack directory at {}, serving loose files only.", directory);
+			return;
+		}
+
+		std::vector<std::filesystem::path> packPaths;
+		for (const auto& item : std::filesystem::directory_iterator(directory, ec)) {
+			if (item.is_regular_file() && PackFormat::NormalizePath(item.path().extension().string()) == PackFormat::FILE_EXTENSION) {
+				packPaths.push_back(item.path());
+			}
+		}
+		std::sort(packPaths.begin(), packPaths.end());
+
+		for (const auto& packPath : packPaths) {
+			Mount(packPath.string());
+		}
+
+		logger::info("PackFileSystem: {} pack(s) mounted from {}, {} file(s) indexed.", packs_.size(), directory, entries_.size());
+	}
+
+	bool PackFileSystem::Mount(const std::string& packPath) {
+		MappedPack pack;
+		pack.file = CreateFileA(packPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (pack.file == INVALID_HANDLE_VALUE) {
+			logger::error("PackFileSystem: Failed to open {} (error {}).", packPath, GetLastError());
+			return false;
+		}
+
+		LARGE_INTEGER fileSize{};
+		if (!GetFileSizeEx(pack.file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(PackFormat::PackHeader))) {
+			logger::error("PackFileSystem: {} is too small to be a pack.", packPath);
+			Unmap(pack);
+			return false;
+		}
+		pack.size = static_cast<uint64_t>(fileSize.QuadPart);
+
+		pack.mapping = CreateFileMappingA(pack.file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!pack.mapping) {
+			logger::error("PackFileSystem: Failed to create mapping for {} (error {}).", packPath, GetLastError());
+			Unmap(pack);
+			return false;
+		}
+
+		pack.view = static_cast<const uint8_t*>(MapViewOfFile(pack.mapping, FILE_MAP_READ, 0, 0, 0));
+		if (!pack.view) {
+			logger::error("PackFileSystem: Failed to map {} (error {}).", packPath, GetLastError());
+			Unmap(pack);
+			return false;
+		}
+
+		PackFormat::PackHeader header;
+		std::memcpy(&header, pack.view, sizeof(header));
+		if (std::memcmp(header.magic, PackFormat::MAGIC, sizeof(header.magic)) != 0 || header.version != PackFormat::VERSION) {
+			logger::error("PackFileSystem: {} is not a version {} pack.", packPath, PackFormat::VERSION);
+			Unmap(pack);
+			return false;
+		}
+
+		if (header.indexOffset > pack.size || header.indexSize > pack.size - header.indexOffset) {
+			logger::error("PackFileSystem: {} has an index outside of the file.", packPath);
+			Unmap(pack);
+			return false;
+		}
+
+		// entryCount comes straight from disk; every entry needs at least a fixed index record, so a count
+		// the index cannot hold means the pack is corrupt, not that we should reserve for it.
+		if (header.entryCount > header.indexSize / sizeof(PackFormat::PackIndexEntry)) {
+			logger::error("PackFileSystem: {} claims {} entries, more than its index can hold.", packPath, header.entryCount);
+			Unmap(pack);
+			return false;
+		}
+
+		// Parse into a staging map first so a corrupt pack does not leave half its entries mounted.
+		std::unordered_map<std::string, Entry> packEntries;
+		packEntries.reserve(header.entryCount);
+
+		const uint8_t* cursor = pack.view + header.indexOffset;
+		const uint8_t* indexEnd = cursor + header.indexSize;
+		for (uint32_t i = 0; i < header.entryCount; i++) {
+			PackFormat::PackIndexEntry indexEntry;
+			if (static_cast<size_t>(indexEnd - cursor) < sizeof(indexEntry)) break;
+			std::memcpy(&indexEntry, cursor, sizeof(indexEntry));
+			cursor += sizeof(indexEntry);
+
+			if (static_cast<uint64_t>(indexEnd - cursor) < static_cast<uint64_t>(indexEntry.pathLength) + indexEntry.mimeTypeLength ||
+				indexEntry.dataOffset > pack.size || indexEntry.dataSize > pack.size - indexEntry.dataOffset) {
+				logger::error("PackFileSystem: {} has a corrupt index entry {}.", packPath, i);
+				Unmap(pack);
+				return false;
+			}
+
+			std::string path(reinterpret_cast<const char*>(cursor), indexEntry.pathLength);
+			cursor += indexEntry.pathLength;
+			std::string mimeType(reinterpret_cast<const char*>(cursor), indexEntry.mimeTypeLength);
+			cursor += indexEntry.mimeTypeLength;
+
+			packEntries[std::move(path)] = Entry{ pack.view + indexEntry.dataOffset, indexEntry.dataSize, std::move(mimeType) };
+		}
+
+		if (packEntries.size() != header.entryCount) {
+			logger::warn("PackFileSystem: {} declares {} entries but {} were read.", packPath, header.entryCount, packEntries.size());
+		}
+
+		for (auto& [path, entry] : packEntries) {
+			entries_.insert_or_assign(path, std::move(entry));
+		}
+		packs_.push_back(pack);
+
+		logger::info("PackFileSystem: Mounted {} ({} file(s), {} KB).", packPath, packEntries.size(), pack.size / 1024);
+		return true;
+	}
+
+	const PackFileSystem::Entry* PackFileSystem::Find(const String& file_path) const {
+		if (entries_.empty()) return nullptr;
+
+		const auto& utf8 = file_path.utf8();
+		auto it = entries_.find(PackFormat::NormalizePath(std::string_view(utf8.data(), utf8.length())));
+		return it != entries_.end() ? &it->second : nullptr;
+	}
+
+	bool PackFileSystem::FileExists(const String& file_path) {
+		if (Find(file_path)) return true;
+		return looseFileSystem_ && looseFileSystem_->FileExists(file_path);
+	}
+
+	String PackFileSystem::GetFileMimeType(const String& file_path) {
+		if (const Entry* entry = Find(file_path)) {
+			return String(entry->mimeType.c_str(), entry->mimeType.size());
+		}
+		if (looseFileSystem_) {
+			return looseFileSystem_->GetFileMimeType(file_path);
+		}
+		const auto& utf8 = file_path.utf8();
+		return String(PackFormat::MimeTypeFromPath(std::string_view(utf8.data(), utf8.length())));
+	}
+
+	String PackFileSystem::GetFileCharset(const String& file_path) {
+		if (Find(file_path)) {
+			return String("utf-8");
+		}
+		return looseFileSystem_ ? looseFileSystem_->GetFileCharset(file_path) : String("utf-8");
+	}
+
+	RefPtr<Buffer> PackFileSystem::OpenFile(const String& file_path) {
+		if (const Entry* entry = Find(file_path)) {
+			// The mapping lives as long as the platform file system, so no destruction callback is needed.
+			return Buffer::Create(const_cast<uint8_t*>(entry->data), static_cast<size_t>(entry->size), nullptr, nullptr);
+		}
+		return looseFileSystem_ ? looseFileSystem_->OpenFile(file_path) : nullptr;
+	}
+}
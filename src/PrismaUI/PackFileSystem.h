@@ -0,0 +1,60 @@
+﻿#pragma once
+
+#include <Ultralight/Ultralight.h>
+#include <Ultralight/platform/FileSystem.h>
+
+#include <windows.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace PrismaUI::PackFileSystem {
+	using namespace ultralight;
+
+	constexpr auto PACKS_DIRECTORY = "Data/PrismaUI/packs";
+
+	// Serves view assets from memory-mapped .prismapack archives. Lookups are a single hash
+	// lookup and OpenFile returns a Buffer that points straight into the mapping. Paths that
+	// are not packed are forwarded to the loose-file system.
+	class PackFileSystem : public FileSystem {
+	public:
+		explicit PackFileSystem(FileSystem* looseFileSystem);
+		virtual ~PackFileSystem();
+
+		PackFileSystem(const PackFileSystem&) = delete;
+		PackFileSystem& operator=(const PackFileSystem&) = delete;
+
+		// Maps every archive in directory. Archives mounted later override earlier entries.
+		void MountDirectory(const std::string& directory);
+		bool Mount(const std::string& packPath);
+
+		size_t GetEntryCount() const { return entries_.size(); }
+
+		virtual bool FileExists(const String& file_path) override;
+		virtual String GetFileMimeType(const String& file_path) override;
+		virtual String GetFileCharset(const String& file_path) override;
+		virtual RefPtr<Buffer> OpenFile(const String& file_path) override;
+
+	private:
+		struct Entry {
+			const uint8_t* data;
+			uint64_t size;
+			std::string mimeType;
+		};
+
+		struct MappedPack {
+			HANDLE file = INVALID_HANDLE_VALUE;
+			HANDLE mapping = nullptr;
+			const uint8_t* view = nullptr;
+			uint64_t size = 0;
+		};
+
+		const Entry* Find(const String& file_path) const;
+		static void Unmap(MappedPack& pack);
+
+		FileSystem* looseFileSystem_;
+		std::vector<MappedPack> packs_;
+		std::unordered_map<std::string, Entry> entries_;
+	};
+}
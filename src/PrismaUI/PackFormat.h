@@ -0,0 +1,108 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// On-disk layout of a .prismapack archive, shared by the plugin and the PrismaPack tool.
+//
+//   PackHeader
+//   file data, each entry aligned to DATA_ALIGNMENT
+//   index: entryCount x (PackIndexEntry, path bytes, mime type bytes)
+//
+// Paths are stored normalized (see NormalizePath) and relative to the Data folder,
+// e.g. "prismaui/views/mymod/index.html".
+namespace PrismaUI::PackFormat {
+	constexpr char MAGIC[4] = { 'P', 'R', 'P', 'K' };
+	constexpr uint32_t VERSION = 1;
+	constexpr uint64_t DATA_ALIGNMENT = 16;
+	constexpr const char* FILE_EXTENSION = ".prismapack";
+
+#pragma pack(push, 1)
+	struct PackHeader {
+		char magic[4];
+		uint32_t version;
+		uint32_t entryCount;
+		uint32_t reserved;
+		uint64_t indexOffset;
+		uint64_t indexSize;
+	};
+
+	struct PackIndexEntry {
+		uint64_t dataOffset;
+		uint64_t dataSize;
+		uint32_t pathLength;
+		uint32_t mimeTypeLength;
+	};
+#pragma pack(pop)
+
+	static_assert(sizeof(PackHeader) == 32);
+	static_assert(sizeof(PackIndexEntry) == 24);
+
+	// Lowercases, converts backslashes and strips leading slashes and the "data/" prefix,
+	// so "file:///Data/PrismaUI/..." lookups and packed paths compare equal.
+	inline std::string NormalizePath(std::string_view path) {
+		std::string result;
+		result.reserve(path.size());
+		for (char c : path) {
+			if (c == '\\') c = '/';
+			if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+			result.push_back(c);
+		}
+
+		size_t start = 0;
+		while (true) {
+			if (result.compare(start, 1, "/") == 0) {
+				start += 1;
+			}
+			else if (result.compare(start, 2, "./") == 0) {
+				start += 2;
+			}
+			else {
+				break;
+			}
+		}
+		if (result.compare(start, 5, "data/") == 0) {
+			start += 5;
+		}
+
+		return result.substr(start);
+	}
+
+	// What Ultralight's FileSystem::GetFileMimeType expects for a type it cannot determine.
+	constexpr const char* UNKNOWN_MIME_TYPE = "application/unknown";
+
+	inline const char* MimeTypeFromPath(std::string_view path) {
+		auto dot = path.find_last_of('.');
+		if (dot == std::string_view::npos) return UNKNOWN_MIME_TYPE;
+
+		std::string ext(path.substr(dot + 1));
+		for (auto& c : ext) {
+			if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+		}
+
+		if (ext == "html" || ext == "htm") return "text/html";
+		if (ext == "js" || ext == "mjs") return "application/javascript";
+		if (ext == "css") return "text/css";
+		if (ext == "json") return "application/json";
+		if (ext == "svg") return "image/svg+xml";
+		if (ext == "png") return "image/png";
+		if (ext == "jpg" || ext == "jpeg") return "image/jpeg";
+		if (ext == "gif") return "image/gif";
+		if (ext == "webp") return "image/webp";
+		if (ext == "ico") return "image/x-icon";
+		if (ext == "ttf") return "font/ttf";
+		if (ext == "otf") return "font/otf";
+		if (ext == "woff") return "font/woff";
+		if (ext == "woff2") return "font/woff2";
+		if (ext == "txt") return "text/plain";
+		if (ext == "xml") return "application/xml";
+		if (ext == "wasm") return "application/wasm";
+		if (ext == "mp3") return "audio/mpeg";
+		if (ext == "ogg") return "audio/ogg";
+		if (ext == "wav") return "audio/wav";
+		if (ext == "mp4") return "video/mp4";
+		if (ext == "webm") return "video/webm";
+		return UNKNOWN_MIME_TYPE;
+	}
+}
@@ -0,0 +1,137 @@
+﻿#include "ScriptScheduler.h"
+#include "Core.h"
+#include "Settings.h"
+
+#include <Utils/DeferredLog/DeferredLog.h>
+
+#include <algorithm>
+
+namespace PrismaUI::ScriptScheduler {
+	using namespace Core;
+	using Clock = std::chrono::steady_clock;
+	using Milliseconds = std::chrono::duration<double, std::milli>;
+
+	static PrismaViewId lastServedViewId = 0;
+
+	void Enqueue(const std::shared_ptr<PrismaView>& viewData, ScriptTask task) {
+		if (!viewData || !task) return;
+
+		std::lock_guard lock(viewData->scriptMutex);
+		viewData->pendingScripts.push_back(std::move(task));
+		viewData->queuedScriptCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	static bool RunNext(PrismaView* viewData) {
+		ScriptTask task;
+		{
+			std::lock_guard lock(viewData->scriptMutex);
+			if (viewData->pendingScripts.empty()) return false;
+
+			task = std::move(viewData->pendingScripts.front());
+			viewData->pendingScripts.pop_front();
+			viewData->queuedScriptCount.fetch_sub(1, std::memory_order_relaxed);
+			if (viewData->scriptsCountedAsDeferred > 0) {
+				viewData->scriptsCountedAsDeferred--;
+			}
+		}
+
+		try {
+			task(viewData->ultralightView.get());
+		}
+		catch (const std::exception& e) {
+			logger::error("ScriptScheduler: Exception in script for View [{}]: {}", viewData->id, e.what());
+		}
+		catch (...) {
+			logger::error("ScriptScheduler: Unknown exception in script for View [{}]", viewData->id);
+		}
+		viewData->scriptsExecuted.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	void ProcessPendingScripts(const Core::ViewSnapshot& snapshot) {
+		// UI thread only, reused so the list is not reallocated every frame. The snapshot keeps the views alive.
+		static std::vector<PrismaView*> queued;
+		queued.clear();
+		size_t firstAfterLastServed = 0;
+		for (const auto& viewData : snapshot.views) {
+			if (viewData->queuedScriptCount.load(std::memory_order_relaxed) == 0) continue;
+			if (viewData->id <= lastServedViewId) firstAfterLastServed++;
+			queued.push_back(viewData.get());
+		}
+		if (queued.empty()) return;
+
+		// Round robin in view id order, continuing after the view that ran the last script of the previous frame.
+		std::rotate(queued.begin(), queued.begin() + (firstAfterLastServed % queued.size()), queued.end());
+
+		auto start = Clock::now();
+		const double budgetMs = Settings::Get().views.scriptFrameBudgetMs;
+		size_t executed = 0;
+		bool budgetSpent = false;
+
+		while (!budgetSpent) {
+			bool ranAny = false;
+			for (const auto& viewData : queued) {
+				if (!RunNext(viewData)) continue;
+				ranAny = true;
+				executed++;
+				lastServedViewId = viewData->id;
+
+				if (Milliseconds(Clock::now() - start).count() >= budgetMs) {
+					budgetSpent = true;
+					break;
+				}
+			}
+			if (!ranAny) break;
+		}
+
+		if (!budgetSpent) return;
+
+		uint64_t deferredThisFrame = 0;
+		for (const auto& viewData : queued) {
+			std::lock_guard lock(viewData->scriptMutex);
+			size_t newlyDeferred = viewData->pendingScripts.size() - viewData->scriptsCountedAsDeferred;
+			viewData->scriptsCountedAsDeferred = viewData->pendingScripts.size();
+			viewData->scriptsDeferred.fetch_add(newlyDeferred, std::memory_order_relaxed);
+			deferredThisFrame += newlyDeferred;
+		}
+
+		if (deferredThisFrame > 0) {
+			DeferredLog::debug("ScriptScheduler: Ran {} script(s) in {:.2f} ms, {} newly carried over to the next frame",
+				executed, Milliseconds(Clock::now() - start).count(), deferredThisFrame);
+		}
+	}
+
+	void DropScripts(const std::shared_ptr<PrismaView>& viewData) {
+		if (!viewData) return;
+
+		std::deque<ScriptTask> dropped;
+		{
+			std::lock_guard lock(viewData->scriptMutex);
+			dropped.swap(viewData->pendingScripts);
+			viewData->scriptsCountedAsDeferred = 0;
+			viewData->queuedScriptCount = 0;
+		}
+
+		for (auto& task : dropped) {
+			try {
+				task(nullptr);
+			}
+			catch (...) {}
+		}
+	}
+
+	ScriptQueueStats GetStats(const Core::PrismaViewId& viewId) {
+		std::shared_ptr<PrismaView> viewData = FindView(viewId);
+
+		if (!viewData) {
+			logger::warn("GetScriptQueueStats: View ID [{}] not found.", viewId);
+			return {};
+		}
+
+		ScriptQueueStats stats;
+		stats.queueDepth = viewData->queuedScriptCount.load(std::memory_order_relaxed);
+		stats.executed = viewData->scriptsExecuted.load(std::memory_order_relaxed);
+		stats.deferred = viewData->scriptsDeferred.load(std::memory_order_relaxed);
+		return stats;
+	}
+}
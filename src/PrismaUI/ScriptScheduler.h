@@ -0,0 +1,37 @@
+﻿#pragma once
+
+#include <Ultralight/Ultralight.h>
+#include <Ultralight/View.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace PrismaUI::Core {
+	typedef uint64_t PrismaViewId;
+	struct PrismaView;
+	struct ViewSnapshot;
+}
+
+namespace PrismaUI::ScriptScheduler {
+	// Runs with the view's Ultralight view, or nullptr when the view is gone or the script was dropped.
+	using ScriptTask = std::function<void(ultralight::View*)>;
+
+	struct ScriptQueueStats {
+		uint32_t queueDepth = 0;
+		uint64_t executed = 0;
+		// Scripts that missed the frame they were queued in because the script budget was spent.
+		uint64_t deferred = 0;
+	};
+
+	void Enqueue(const std::shared_ptr<Core::PrismaView>& viewData, ScriptTask task);
+
+	// Called on the UI thread once per frame. Runs queued scripts one per view in turn until the
+	// frame's script budget is spent, starting after the view served last. At least one script runs every frame.
+	void ProcessPendingScripts(const Core::ViewSnapshot& snapshot);
+
+	// Runs every queued script of the view with nullptr so callbacks still fire. UI thread only.
+	void DropScripts(const std::shared_ptr<Core::PrismaView>& viewData);
+
+	ScriptQueueStats GetStats(const Core::PrismaViewId& viewId);
+}
@@ -0,0 +1,229 @@
+﻿#include "Settings.h"
+
+#include <windows.h>
+#include <charconv>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace PrismaUI::Settings {
+	static PrismaSettings settings;
+	static std::string settingsFilePath;
+
+	static constexpr uint32_t MEGABYTE = 1024 * 1024;
+
+	static std::optional<std::string> ReadString(const char* section, const char* key) {
+		char buffer[256] = { 0 };
+		DWORD length = GetPrivateProfileStringA(section, key, "", buffer, sizeof(buffer), settingsFilePath.c_str());
+		if (length == 0) {
+			return std::nullopt;
+		}
+
+		// ';' and '#' start a trailing comment only at the start of the value or after whitespace,
+		// so paths like "C:\Mods\#UI" are kept whole.
+		std::string value(buffer, length);
+		for (size_t comment = value.find_first_of(";#"); comment != std::string::npos; comment = value.find_first_of(";#", comment + 1)) {
+			if (comment == 0 || isspace(static_cast<unsigned char>(value[comment - 1]))) {
+				value.erase(comment);
+				break;
+			}
+		}
+		while (!value.empty() && isspace(static_cast<unsigned char>(value.back()))) {
+			value.pop_back();
+		}
+		if (value.empty()) {
+			return std::nullopt;
+		}
+		return value;
+	}
+
+	template <typename T>
+	static T ReadNumber(const char* section, const char* key, T defaultValue, T minValue, T maxValue) {
+		auto raw = ReadString(section, key);
+		if (!raw) {
+			return defaultValue;
+		}
+
+		T value{};
+		auto [ptr, ec] = std::from_chars(raw->data(), raw->data() + raw->size(), value);
+		if (ec != std::errc() || ptr != raw->data() + raw->size()) {
+			logger::warn("Settings: [{}] {} = '{}' is not a valid number, using default {}.", section, key, *raw, defaultValue);
+			return defaultValue;
+		}
+
+		if (value < minValue || value > maxValue) {
+			T clamped = value < minValue ? minValue : maxValue;
+			logger::warn("Settings: [{}] {} = {} is out of range [{}, {}], clamped to {}.", section, key, value, minValue, maxValue, clamped);
+			return clamped;
+		}
+
+		return value;
+	}
+
+	static uint32_t ReadMegabytes(const char* section, const char* key, uint32_t defaultBytes, uint32_t minMegabytes, uint32_t maxMegabytes) {
+		return ReadNumber<uint32_t>(section, key, defaultBytes / MEGABYTE, minMegabytes, maxMegabytes) * MEGABYTE;
+	}
+
+	static bool ReadBool(const char* section, const char* key, bool defaultValue) {
+		auto raw = ReadString(section, key);
+		if (!raw) {
+			return defaultValue;
+		}
+
+		if (*raw == "1" || _stricmp(raw->c_str(), "true") == 0) {
+			return true;
+		}
+		if (*raw == "0" || _stricmp(raw->c_str(), "false") == 0) {
+			return false;
+		}
+
+		logger::warn("Settings: [{}] {} = '{}' is not a valid boolean, using default {}.", section, key, *raw, defaultValue);
+		return defaultValue;
+	}
+
+	static constexpr const char* LOG_LEVEL_NAMES[] = { "trace", "debug", "info", "warn", "error", "critical", "off" };
+
+	static DeferredLog::Level ReadLogLevel(const char* section, const char* key, DeferredLog::Level defaultValue) {
+		auto raw = ReadString(section, key);
+		if (!raw) {
+			return defaultValue;
+		}
+
+		for (size_t i = 0; i < std::size(LOG_LEVEL_NAMES); i++) {
+			if (_stricmp(raw->c_str(), LOG_LEVEL_NAMES[i]) == 0) {
+				return static_cast<DeferredLog::Level>(i);
+			}
+		}
+
+		logger::warn("Settings: [{}] {} = '{}' is not a valid log level, using default {}.", section, key, *raw, LOG_LEVEL_NAMES[static_cast<size_t>(defaultValue)]);
+		return defaultValue;
+	}
+
+	void Load() {
+		settingsFilePath = std::filesystem::absolute(SETTINGS_FILE_PATH).string();
+		settings = PrismaSettings{};
+
+		if (!std::filesystem::exists(settingsFilePath)) {
+			logger::info("Settings: {} not found, using defaults.", SETTINGS_FILE_PATH);
+			return;
+		}
+
+		logger::info("Settings: Loading {}", SETTINGS_FILE_PATH);
+
+		const PrismaSettings defaults;
+		auto& ul = settings.ultralight;
+
+		ul.numRendererThreads = ReadNumber<uint32_t>("Ultralight", "iNumRendererThreads", defaults.ultralight.numRendererThreads, 0, 64);
+		ul.memoryCacheSize = ReadMegabytes("Ultralight", "iMemoryCacheSizeMB", defaults.ultralight.memoryCacheSize, 0, 1024);
+		ul.pageCacheSize = ReadNumber<uint32_t>("Ultralight", "iPageCacheSize", defaults.ultralight.pageCacheSize, 0, 32);
+		ul.recycleDelay = ReadNumber<double>("Ultralight", "fRecycleDelay", defaults.ultralight.recycleDelay, 0.1, 60.0);
+		ul.animationTimerDelay = ReadNumber<double>("Ultralight", "fAnimationTimerDelay", defaults.ultralight.animationTimerDelay, 1.0 / 240.0, 1.0);
+		ul.scrollTimerDelay = ReadNumber<double>("Ultralight", "fScrollTimerDelay", defaults.ultralight.scrollTimerDelay, 1.0 / 240.0, 1.0);
+		ul.maxUpdateTime = ReadNumber<double>("Ultralight", "fMaxUpdateTime", defaults.ultralight.maxUpdateTime, 0.0005, 0.1);
+		ul.bitmapAlignment = ReadNumber<uint32_t>("Ultralight", "iBitmapAlignment", defaults.ultralight.bitmapAlignment, 0, 64);
+		ul.minLargeHeapSize = ReadMegabytes("Ultralight", "iMinLargeHeapSizeMB", defaults.ultralight.minLargeHeapSize, 1, 512);
+		ul.minSmallHeapSize = ReadMegabytes("Ultralight", "iMinSmallHeapSizeMB", defaults.ultralight.minSmallHeapSize, 1, 64);
+
+		if (auto cachePath = ReadString("Ultralight", "sCachePath")) {
+			ul.cachePath = *cachePath;
+		}
+
+		if (ul.bitmapAlignment != 0 && (ul.bitmapAlignment & (ul.bitmapAlignment - 1)) != 0) {
+			logger::warn("Settings: [Ultralight] iBitmapAlignment = {} is not a power of two, using default {}.", ul.bitmapAlignment, defaults.ultralight.bitmapAlignment);
+			ul.bitmapAlignment = defaults.ultralight.bitmapAlignment;
+		}
+
+		settings.renderer.frameCopyWorkers = ReadNumber<uint32_t>("Renderer", "iFrameCopyWorkers", defaults.renderer.frameCopyWorkers, 0, 16);
+		settings.renderer.texturePoolBytes = static_cast<uint64_t>(ReadNumber<uint32_t>("Renderer", "iTexturePoolMB", static_cast<uint32_t>(defaults.renderer.texturePoolBytes / MEGABYTE), 0, 2048)) * MEGABYTE;
+
+		auto& memory = settings.memory;
+		memory.budgetBytes = static_cast<uint64_t>(ReadNumber<uint32_t>("Memory", "iBudgetMB", static_cast<uint32_t>(defaults.memory.budgetBytes / MEGABYTE), 0, 16384)) * MEGABYTE;
+		memory.evictHiddenAfterSeconds = ReadNumber<double>("Memory", "fEvictHiddenAfterSeconds", defaults.memory.evictHiddenAfterSeconds, 0.0, 3600.0);
+		memory.purgeOnLoadingScreen = ReadBool("Memory", "bPurgeOnLoadingScreen", defaults.memory.purgeOnLoadingScreen);
+		memory.purgeCooldownSeconds = ReadNumber<double>("Memory", "fPurgeCooldownSeconds", defaults.memory.purgeCooldownSeconds, 1.0, 600.0);
+		memory.frameBufferCacheBytes = static_cast<uint64_t>(ReadNumber<uint32_t>("Memory", "iFrameBufferCacheMB", static_cast<uint32_t>(defaults.memory.frameBufferCacheBytes / MEGABYTE), 0, 4096)) * MEGABYTE;
+		memory.largePageFrameBuffers = ReadBool("Memory", "bLargePageFrameBuffers", defaults.memory.largePageFrameBuffers);
+
+		settings.views.autoHibernateAfterSeconds = ReadNumber<double>("Views", "fAutoHibernateAfterSeconds", defaults.views.autoHibernateAfterSeconds, 0.0, 3600.0);
+		settings.views.creationFrameBudgetMs = ReadNumber<double>("Views", "fCreationFrameBudgetMs", defaults.views.creationFrameBudgetMs, 0.1, 100.0);
+		settings.views.scriptFrameBudgetMs = ReadNumber<double>("Views", "fScriptFrameBudgetMs", defaults.views.scriptFrameBudgetMs, 0.1, 100.0);
+
+		auto& prewarm = settings.prewarm;
+		prewarm.maxViews = ReadNumber<uint32_t>("Prewarm", "iMaxViews", defaults.prewarm.maxViews, 0, 64);
+		prewarm.memoryBudgetBytes = static_cast<uint64_t>(ReadNumber<uint32_t>("Prewarm", "iMemoryBudgetMB", static_cast<uint32_t>(defaults.prewarm.memoryBudgetBytes / MEGABYTE), 0, 4096)) * MEGABYTE;
+		prewarm.frameBudgetMs = ReadNumber<double>("Prewarm", "fFrameBudgetMs", defaults.prewarm.frameBudgetMs, 0.1, 50.0);
+
+		settings.fileSystem.enablePacks = ReadBool("FileSystem", "bEnablePacks", defaults.fileSystem.enablePacks);
+		settings.fileSystem.prefetchAssets = ReadBool("FileSystem", "bPrefetchAssets", defaults.fileSystem.prefetchAssets);
+		settings.fileSystem.assetCacheBytes = static_cast<uint64_t>(ReadNumber<uint32_t>("FileSystem", "iAssetCacheMB", static_cast<uint32_t>(defaults.fileSystem.assetCacheBytes / MEGABYTE), 0, 4096)) * MEGABYTE;
+
+		settings.fonts.preloadOnLoadingScreen = ReadBool("Fonts", "bPreloadOnLoadingScreen", defaults.fonts.preloadOnLoadingScreen);
+
+		settings.logging.deferredLevel = ReadLogLevel("Logging", "sDeferredLevel", defaults.logging.deferredLevel);
+		settings.logging.ultralightLevel = ReadLogLevel("Logging", "sUltralightLevel", defaults.logging.ultralightLevel);
+
+		settings.console.minLevel = ReadLogLevel("Console", "sMinLevel", defaults.console.minLevel);
+		settings.console.messagesPerSecond = ReadNumber<double>("Console", "fMessagesPerSecond", defaults.console.messagesPerSecond, 0.0, 10000.0);
+		settings.console.burst = ReadNumber<uint32_t>("Console", "iBurst", defaults.console.burst, 1, 100000);
+		settings.console.deduplicate = ReadBool("Console", "bDeduplicate", defaults.console.deduplicate);
+		settings.console.perViewFiles = ReadBool("Console", "bPerViewFiles", defaults.console.perViewFiles);
+
+		settings.developer.hotReload = ReadBool("Developer", "bHotReload", defaults.developer.hotReload);
+		settings.developer.hotReloadDebounceMs = ReadNumber<double>("Developer", "fHotReloadDebounceMs", defaults.developer.hotReloadDebounceMs, 10.0, 5000.0);
+	}
+
+	const PrismaSettings& Get() {
+		return settings;
+	}
+
+	void ApplyToConfig(ultralight::Config& config) {
+		const auto& ul = settings.ultralight;
+		config.num_renderer_threads = ul.numRendererThreads;
+		config.memory_cache_size = ul.memoryCacheSize;
+		config.page_cache_size = ul.pageCacheSize;
+		config.recycle_delay = ul.recycleDelay;
+		config.animation_timer_delay = ul.animationTimerDelay;
+		config.scroll_timer_delay = ul.scrollTimerDelay;
+		config.max_update_time = ul.maxUpdateTime;
+		config.bitmap_alignment = ul.bitmapAlignment;
+		config.min_large_heap_size = ul.minLargeHeapSize;
+		config.min_small_heap_size = ul.minSmallHeapSize;
+
+		// The folder itself is created by the first persistent session, see Core::GetOrCreateSession.
+		if (!ul.cachePath.empty()) {
+			config.cache_path = ultralight::String(std::filesystem::absolute(ul.cachePath).string().c_str());
+		}
+	}
+
+	void LogEffectiveSettings() {
+		const auto& ul = settings.ultralight;
+		logger::info("Settings: [Ultralight] iNumRendererThreads={} iMemoryCacheSizeMB={} iPageCacheSize={} fRecycleDelay={}",
+			ul.numRendererThreads, ul.memoryCacheSize / MEGABYTE, ul.pageCacheSize, ul.recycleDelay);
+		logger::info("Settings: [Ultralight] fAnimationTimerDelay={} fScrollTimerDelay={} fMaxUpdateTime={} iBitmapAlignment={}",
+			ul.animationTimerDelay, ul.scrollTimerDelay, ul.maxUpdateTime, ul.bitmapAlignment);
+		logger::info("Settings: [Ultralight] iMinLargeHeapSizeMB={} iMinSmallHeapSizeMB={} sCachePath={}",
+			ul.minLargeHeapSize / MEGABYTE, ul.minSmallHeapSize / MEGABYTE, ul.cachePath);
+		logger::info("Settings: [Renderer] iFrameCopyWorkers={} iTexturePoolMB={}", settings.renderer.frameCopyWorkers, settings.renderer.texturePoolBytes / MEGABYTE);
+
+		const auto& memory = settings.memory;
+		logger::info("Settings: [Memory] iBudgetMB={} fEvictHiddenAfterSeconds={} bPurgeOnLoadingScreen={} fPurgeCooldownSeconds={}",
+			memory.budgetBytes / MEGABYTE, memory.evictHiddenAfterSeconds, memory.purgeOnLoadingScreen, memory.purgeCooldownSeconds);
+		logger::info("Settings: [Memory] iFrameBufferCacheMB={} bLargePageFrameBuffers={}",
+			memory.frameBufferCacheBytes / MEGABYTE, memory.largePageFrameBuffers);
+		logger::info("Settings: [Views] fAutoHibernateAfterSeconds={} fCreationFrameBudgetMs={} fScriptFrameBudgetMs={}",
+			settings.views.autoHibernateAfterSeconds, settings.views.creationFrameBudgetMs, settings.views.scriptFrameBudgetMs);
+
+		const auto& prewarm = settings.prewarm;
+		logger::info("Settings: [Prewarm] iMaxViews={} iMemoryBudgetMB={} fFrameBudgetMs={}",
+			prewarm.maxViews, prewarm.memoryBudgetBytes / MEGABYTE, prewarm.frameBudgetMs);
+		logger::info("Settings: [FileSystem] bEnablePacks={} iAssetCacheMB={} bPrefetchAssets={}",
+			settings.fileSystem.enablePacks, settings.fileSystem.assetCacheBytes / MEGABYTE, settings.fileSystem.prefetchAssets);
+		logger::info("Settings: [Fonts] bPreloadOnLoadingScreen={}", settings.fonts.preloadOnLoadingScreen);
+		logger::info("Settings: [Logging] sDeferredLevel={}, sUltralightLevel={}", LOG_LEVEL_NAMES[static_cast<size_t>(settings.logging.deferredLevel)],
+			LOG_LEVEL_NAMES[static_cast<size_t>(settings.logging.ultralightLevel)]);
+		logger::info("Settings: [Console] sMinLevel={}, fMessagesPerSecond={}, iBurst={}, bDeduplicate={}, bPerViewFiles={}",
+			LOG_LEVEL_NAMES[static_cast<size_t>(settings.console.minLevel)], settings.console.messagesPerSecond, settings.console.burst,
+			settings.console.deduplicate, settings.console.perViewFiles);
+		logger::info("Settings: [Developer] bHotReload={} fHotReloadDebounceMs={}", settings.developer.hotReload, settings.developer.hotReloadDebounceMs);
+	}
+}
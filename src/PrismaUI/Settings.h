@@ -0,0 +1,122 @@
+﻿#pragma once
+
+#include <Ultralight/Ultralight.h>
+#include <Utils/DeferredLog/DeferredLog.h>
+
+#include <cstdint>
+#include <string>
+
+namespace PrismaUI::Settings {
+	constexpr auto SETTINGS_FILE_PATH = "Data/SKSE/Plugins/PrismaUI.ini";
+
+	// Values mapped onto ultralight::Config, see Ultralight/platform/Config.h for their meaning.
+	struct UltralightSettings {
+		uint32_t numRendererThreads = 0;
+		uint32_t memoryCacheSize = 64 * 1024 * 1024;
+		uint32_t pageCacheSize = 0;
+		double recycleDelay = 4.0;
+		double animationTimerDelay = 1.0 / 60.0;
+		double scrollTimerDelay = 1.0 / 60.0;
+		double maxUpdateTime = 1.0 / 200.0;
+		uint32_t bitmapAlignment = 16;
+		uint32_t minLargeHeapSize = 32 * 1024 * 1024;
+		uint32_t minSmallHeapSize = 1 * 1024 * 1024;
+		// Where named persistent sessions keep cookies, localStorage and IndexedDB, one folder per session.
+		// Views created without a session name use an in-memory session and never write here.
+		std::string cachePath = "Data/SKSE/Plugins/PrismaUI/Storage";
+	};
+
+	struct RendererSettings {
+		uint32_t frameCopyWorkers = 2;
+		// Freed view textures kept for reuse by a view of the same size, 0 disables the pool.
+		uint64_t texturePoolBytes = 64ull * 1024 * 1024;
+	};
+
+	struct MemorySettings {
+		uint64_t budgetBytes = 512ull * 1024 * 1024;
+		double evictHiddenAfterSeconds = 30.0;
+		bool purgeOnLoadingScreen = true;
+		double purgeCooldownSeconds = 10.0;
+		// Released frame buffers kept for the next view of a similar size, see BufferArena.
+		uint64_t frameBufferCacheBytes = 128ull * 1024 * 1024;
+		// Back frame buffers with large pages, needs the "Lock pages in memory" privilege.
+		bool largePageFrameBuffers = false;
+	};
+
+	struct ViewSettings {
+		// Hidden views are hibernated after this many seconds, 0 disables automatic hibernation.
+		double autoHibernateAfterSeconds = 0.0;
+		// Time the UI thread may spend creating views per frame, the first pending view is always created.
+		double creationFrameBudgetMs = 4.0;
+		// Time the UI thread may spend running Invoke/InteropCall scripts per frame, the rest carries over.
+		double scriptFrameBudgetMs = 4.0;
+	};
+
+	struct PrewarmSettings {
+		uint32_t maxViews = 4;
+		uint64_t memoryBudgetBytes = 256ull * 1024 * 1024;
+		double frameBudgetMs = 2.0;
+	};
+
+	struct FileSystemSettings {
+		// Serve view assets from Data/PrismaUI/packs/*.prismapack before falling back to loose files.
+		bool enablePacks = true;
+		// Shared LRU of loose-file contents, 0 disables the cache.
+		uint64_t assetCacheBytes = 64ull * 1024 * 1024;
+		// Read a new view's HTML and referenced assets into the cache on a background thread before creating it.
+		bool prefetchAssets = true;
+	};
+
+	struct FontSettings {
+		// Read fonts marked preload in Data/PrismaUI/fonts/*.ini during the first loading screen.
+		bool preloadOnLoadingScreen = true;
+	};
+
+	struct LoggingSettings {
+		// Level of the deferred hot-path log (operation queue, JS callbacks, console messages).
+#ifdef NDEBUG
+		DeferredLog::Level deferredLevel = DeferredLog::Level::Info;
+#else
+		DeferredLog::Level deferredLevel = DeferredLog::Level::Debug;
+#endif
+		// Minimum level of Ultralight's own messages (resource loads, memory, fonts) that are logged.
+		DeferredLog::Level ultralightLevel = DeferredLog::Level::Warn;
+	};
+
+	struct ConsoleSettings {
+		// JS console messages below this level are dropped before they reach the log.
+		DeferredLog::Level minLevel = DeferredLog::Level::Info;
+		// Token bucket per view, 0 disables rate limiting.
+		double messagesPerSecond = 50.0;
+		uint32_t burst = 200;
+		// Collapse identical consecutive messages into one "repeated N times" line.
+		bool deduplicate = true;
+		// Also write each view's console to Data/SKSE/Plugins/PrismaUI/Console/<page>-<id>.log.
+		bool perViewFiles = false;
+	};
+
+	struct DeveloperSettings {
+		// Reload views when files under Data/PrismaUI/views change, see HotReload.
+		bool hotReload = false;
+		// Editors write a file in several steps, changes are collected until nothing changed for this long.
+		double hotReloadDebounceMs = 200.0;
+	};
+
+	struct PrismaSettings {
+		UltralightSettings ultralight;
+		RendererSettings renderer;
+		MemorySettings memory;
+		ViewSettings views;
+		PrewarmSettings prewarm;
+		FileSystemSettings fileSystem;
+		FontSettings fonts;
+		LoggingSettings logging;
+		ConsoleSettings console;
+		DeveloperSettings developer;
+	};
+
+	void Load();
+	const PrismaSettings& Get();
+	void ApplyToConfig(ultralight::Config& config);
+	void LogEffectiveSettings();
+}
@@ -0,0 +1,128 @@
+﻿#include "ViewCreationScheduler.h"
+#include "Core.h"
+#include "Listeners.h"
+#include "Settings.h"
+
+#include <algorithm>
+#include <array>
+
+namespace PrismaUI::ViewCreationScheduler {
+	using namespace Core;
+	using Clock = std::chrono::steady_clock;
+	using Milliseconds = std::chrono::duration<double, std::milli>;
+
+	static constexpr const char* CREATION_FAILED_MARKER = "[CREATION FAILED]";
+
+	double CreateUltralightView(const std::shared_ptr<PrismaView>& viewData) {
+		if (viewData->ultralightView) return 0.0;
+
+		auto start = Clock::now();
+
+		logger::info("UI Thread: Creating View [{}] for path: {}", viewData->id, viewData->htmlPathToLoad);
+
+		if (screenSize.width == 0 || screenSize.height == 0) {
+			logger::error("UI Thread: Cannot create View [{}], screen size is zero.", viewData->id);
+			return 0.0;
+		}
+
+		ViewConfig view_config;
+		view_config.is_accelerated = false;
+		view_config.is_transparent = true;
+		view_config.initial_focus = false;
+		view_config.enable_images = true;
+		view_config.enable_javascript = true;
+		view_config.enable_compositor = false;
+
+		RefPtr<Session> session = GetOrCreateSession(viewData->sessionName, viewData->persistentSession);
+
+		viewData->ultralightView = renderer->CreateView(screenSize.width, screenSize.height, view_config, session);
+
+		if (viewData->ultralightView) {
+			viewData->loadListener = std::make_unique<Listeners::MyLoadListener>(viewData->id);
+			viewData->viewListener = std::make_unique<Listeners::MyViewListener>(viewData->id);
+			viewData->ultralightView->set_load_listener(viewData->loadListener.get());
+			viewData->ultralightView->set_view_listener(viewData->viewListener.get());
+			viewData->ultralightView->LoadURL(String(viewData->htmlPathToLoad.c_str()));
+			viewData->ultralightView->Unfocus();
+			viewData->htmlPathToLoad.clear();
+			viewData->isCreated = true;
+		}
+		else {
+			logger::error("UI Thread: Failed to create Ultralight View for ID [{}].", viewData->id);
+			viewData->htmlPathToLoad = CREATION_FAILED_MARKER;
+			return Milliseconds(Clock::now() - start).count();
+		}
+
+		double elapsedMs = Milliseconds(Clock::now() - start).count();
+		if (elapsedMs >= SLOW_CREATION_WARN_MS) {
+			logger::warn("UI Thread: View [{}] created in {:.2f} ms, creation stalled the frame.", viewData->id, elapsedMs);
+		}
+		else {
+			logger::info("UI Thread: View [{}] successfully created in {:.2f} ms and loading URL.", viewData->id, elapsedMs);
+		}
+		return elapsedMs;
+	}
+
+	struct PendingCreation {
+		std::shared_ptr<PrismaView> viewData;
+		bool prewarm;
+		int priority;
+		size_t drawRank;
+	};
+
+	void ProcessPendingCreations(const Core::ViewSnapshot& snapshot, bool prewarmAllowed) {
+		// order is written by SetOrder on API threads, so z-order comes from the snapshot's drawOrder,
+		// which was sorted under viewsMutex, instead of being read here.
+		std::array<size_t, MAX_VIEW_SLOTS> drawRank{};
+		for (size_t i = 0; i < snapshot.drawOrder.size(); i++) {
+			drawRank[snapshot.drawOrder[i]] = i;
+		}
+
+		std::vector<PendingCreation> pending;
+		for (const auto& viewData : snapshot.views) {
+			// Views still being prefetched wait, so LoadURL finds their assets in the cache.
+			if (!viewData->ultralightView && !viewData->htmlPathToLoad.empty() &&
+				viewData->htmlPathToLoad != CREATION_FAILED_MARKER && !viewData->prefetchPending.load()) {
+				// Keys are loaded once so the comparator stays consistent if an API thread changes them mid-sort.
+				pending.push_back({ viewData, viewData->isPrewarmed.load(), viewData->creationPriority.load(), drawRank[viewData->slot] });
+			}
+		}
+
+		if (pending.empty()) return;
+
+		// Regular views before pre-warmed ones, then explicit priority, then z-order.
+		// New views are placed on top, so z-order is request order unless SetOrder moved a view.
+		std::sort(pending.begin(), pending.end(), [](const PendingCreation& a, const PendingCreation& b) {
+			if (a.prewarm != b.prewarm) return !a.prewarm;
+			if (a.priority != b.priority) return a.priority > b.priority;
+			return a.drawRank < b.drawRank;
+		});
+
+		const auto& settings = Settings::Get();
+		const Milliseconds frameBudget(settings.views.creationFrameBudgetMs);
+		const Milliseconds prewarmBudget(settings.prewarm.frameBudgetMs);
+
+		auto frameStart = Clock::now();
+		size_t created = 0;
+
+		for (const auto& creation : pending) {
+			Milliseconds spent = Clock::now() - frameStart;
+
+			if (creation.prewarm) {
+				// Pre-warmed views never hold up a frame, and only load while the player is not in a view.
+				if (!prewarmAllowed || spent >= prewarmBudget || spent >= frameBudget) break;
+			}
+			else if (created > 0 && spent >= frameBudget) {
+				break;
+			}
+
+			CreateUltralightView(creation.viewData);
+			created++;
+		}
+
+		if (created < pending.size()) {
+			logger::debug("ViewCreationScheduler: Created {} view(s) in {:.2f} ms, {} deferred to next frame.",
+				created, Milliseconds(Clock::now() - frameStart).count(), pending.size() - created);
+		}
+	}
+}
@@ -0,0 +1,23 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <memory>
+
+namespace PrismaUI::Core {
+	typedef uint64_t PrismaViewId;
+	struct PrismaView;
+	struct ViewSnapshot;
+}
+
+namespace PrismaUI::ViewCreationScheduler {
+	// Creation cost above this is reported as a warning instead of a debug line.
+	constexpr double SLOW_CREATION_WARN_MS = 16.0;
+
+	// Called on the UI thread once per frame. Creates pending views in priority order until
+	// the frame's creation budget is spent. At least one regular view is created every frame.
+	void ProcessPendingCreations(const Core::ViewSnapshot& snapshot, bool prewarmAllowed);
+
+	// Creates the Ultralight view for viewData and starts loading its URL. UI thread only.
+	// Returns the time spent in milliseconds.
+	double CreateUltralightView(const std::shared_ptr<Core::PrismaView>& viewData);
+}
@@ -0,0 +1,68 @@
+﻿#include "ViewFrameTable.h"
+
+#include <algorithm>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace PrismaUI::Core {
+	ViewFrameTable frameTable;
+	static_assert(std::is_trivially_destructible_v<ViewFrameTable>, "frameTable must stay usable during static destruction");
+
+	struct SlotAllocator {
+		std::mutex mutex;
+		std::vector<ViewSlot> freeSlots;
+		ViewSlot nextUnusedSlot = 0;
+	};
+
+	// Never destroyed: the last PrismaView can be released during static destruction at exit
+	// (Shutdown is not called on every exit path), after file-scope statics here would be gone.
+	static SlotAllocator& GetSlotAllocator() {
+		static auto& allocator = *new SlotAllocator;
+		return allocator;
+	}
+
+	static void ResetSlot(ViewSlot slot) {
+		frameTable.isHidden[slot] = false;
+		frameTable.isHibernated[slot] = false;
+		frameTable.newFrameReady[slot] = false;
+		frameTable.pendingResourceRelease[slot] = false;
+		frameTable.queuedOperationsCount[slot] = 0;
+		frameTable.texture[slot] = nullptr;
+		frameTable.textureView[slot] = nullptr;
+		frameTable.textureWidth[slot] = 0;
+		frameTable.textureHeight[slot] = 0;
+		frameTable.order[slot] = 0;
+	}
+
+	ViewSlot AcquireViewSlot() {
+		SlotAllocator& allocator = GetSlotAllocator();
+		ViewSlot slot;
+		{
+			std::lock_guard lock(allocator.mutex);
+			if (!allocator.freeSlots.empty()) {
+				// Lowest slot first keeps the live part of the arrays dense.
+				auto lowest = std::min_element(allocator.freeSlots.begin(), allocator.freeSlots.end());
+				slot = *lowest;
+				*lowest = allocator.freeSlots.back();
+				allocator.freeSlots.pop_back();
+			}
+			else if (allocator.nextUnusedSlot < MAX_VIEW_SLOTS) {
+				slot = allocator.nextUnusedSlot++;
+			}
+			else {
+				return INVALID_VIEW_SLOT;
+			}
+		}
+		ResetSlot(slot);
+		return slot;
+	}
+
+	void ReleaseViewSlot(ViewSlot slot) {
+		if (slot >= MAX_VIEW_SLOTS) return;
+
+		SlotAllocator& allocator = GetSlotAllocator();
+		std::lock_guard lock(allocator.mutex);
+		allocator.freeSlots.push_back(slot);
+	}
+}
@@ -0,0 +1,43 @@
+﻿#pragma once
+
+#include <d3d11.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace PrismaUI::Core {
+	typedef uint32_t ViewSlot;
+
+	constexpr ViewSlot MAX_VIEW_SLOTS = 256;
+	constexpr ViewSlot INVALID_VIEW_SLOT = UINT32_MAX;
+
+	// Fields every frame reads for every view, stored as one array per field and indexed by the view's slot.
+	// The frame loop scans a few contiguous arrays instead of pulling each view's PrismaView into cache;
+	// PrismaView refers to its own entries, so code that works on a single view is unchanged.
+	struct ViewFrameTable {
+		std::array<std::atomic<bool>, MAX_VIEW_SLOTS> isHidden{};
+		std::array<std::atomic<bool>, MAX_VIEW_SLOTS> isHibernated{};
+		std::array<std::atomic<bool>, MAX_VIEW_SLOTS> newFrameReady{};
+		std::array<std::atomic<bool>, MAX_VIEW_SLOTS> pendingResourceRelease{};
+		std::array<std::atomic<int>, MAX_VIEW_SLOTS> queuedOperationsCount{};
+
+		// Render thread only.
+		std::array<ID3D11Texture2D*, MAX_VIEW_SLOTS> texture{};
+		std::array<ID3D11ShaderResourceView*, MAX_VIEW_SLOTS> textureView{};
+		// Written by the render thread, also read by memory accounting on API threads.
+		std::array<std::atomic<uint32_t>, MAX_VIEW_SLOTS> textureWidth{};
+		std::array<std::atomic<uint32_t>, MAX_VIEW_SLOTS> textureHeight{};
+
+		// Written under viewsMutex, read from the draw order of the view snapshot.
+		std::array<int, MAX_VIEW_SLOTS> order{};
+	};
+
+	// Only atomics, pointers and integers, so nothing runs at static destruction and views released
+	// at exit can still reach their entries.
+	extern ViewFrameTable frameTable;
+
+	// Reserves a slot and resets its fields, INVALID_VIEW_SLOT when every slot is in use.
+	ViewSlot AcquireViewSlot();
+	void ReleaseViewSlot(ViewSlot slot);
+}
@@ -3,11 +3,16 @@
 #include "InputHandler.h"
 #include "Listeners.h"
 #include "ViewOperationQueue.h"
+#include "Settings.h"
+#include "AssetPrefetcher.h"
+#include "ConsoleRouter.h"
+#include "ScriptScheduler.h"
+#include "ViewRenderer.h"
 
 namespace PrismaUI::ViewManager {
 	using namespace Core;
 
-	Core::PrismaViewId Create(const std::string& htmlPath, std::function<void(Core::PrismaViewId)> onDomReadyCallback) {
+	static void EnsureCoreInitialized() {
 		bool expected_init = false;
 		if (coreInitialized.compare_exchange_strong(expected_init, true)) {
 			Core::InitializeCoreSystem();
@@ -21,7 +26,35 @@ namespace PrismaUI::ViewManager {
 			logger::critical("Cannot create HTML view: Core Renderer is null despite initialization flag.");
 			throw std::runtime_error("PrismaUI Core Renderer is unexpectedly null.");
 		}
+	}
+
+	// Caller holds viewsMutex exclusively, so the count cannot change before the new view is added.
+	static bool CanPrewarmLocked(const std::string& htmlPath) {
+		const auto& prewarmSettings = Settings::Get().prewarm;
+		uint32_t prewarmedCount = 0;
+		for (const auto& pair : views) {
+			if (pair.second->isPrewarmed.load()) {
+				prewarmedCount++;
+			}
+		}
+
+		if (prewarmedCount >= prewarmSettings.maxViews) {
+			logger::warn("Prewarm: Limit of {} pre-warmed view(s) reached, request for {} rejected.", prewarmSettings.maxViews, htmlPath);
+			return false;
+		}
 
+		// Each hidden view keeps a full-screen BGRA surface alive inside Ultralight.
+		uint64_t viewBytes = static_cast<uint64_t>(screenSize.width) * screenSize.height * 4;
+		if (viewBytes > 0 && (prewarmedCount + 1) * viewBytes > prewarmSettings.memoryBudgetBytes) {
+			logger::warn("Prewarm: Memory budget of {} MB would be exceeded, request for {} rejected.", prewarmSettings.memoryBudgetBytes / (1024 * 1024), htmlPath);
+			return false;
+		}
+
+		return true;
+	}
+
+	static Core::PrismaViewId CreateInternal(const std::string& htmlPath, std::function<void(Core::PrismaViewId)> onDomReadyCallback, bool prewarm,
+		const std::string& sessionName = "", bool persistentSession = true) {
 		Core::PrismaViewId newViewId = generator.generate();
 		
 		// Check if htmlPath is a website URL (starts with http:// or https://)
@@ -32,15 +65,30 @@ namespace PrismaUI::ViewManager {
 			fileUrl = "file:///Data/PrismaUI/views/" + htmlPath;
 		}
 
-		auto viewData = std::make_shared<Core::PrismaView>();
+		Core::ViewSlot slot = AcquireViewSlot();
+		if (slot == INVALID_VIEW_SLOT) {
+			logger::error("Create: Limit of {} views reached, request for {} rejected.", MAX_VIEW_SLOTS, htmlPath);
+			return 0;
+		}
+
+		auto viewData = std::make_shared<Core::PrismaView>(slot);
 		viewData->id = newViewId;
 		viewData->ultralightView = nullptr;
 		viewData->htmlPathToLoad = fileUrl;
-		viewData->isHidden = false;
+		viewData->isHidden = prewarm;
+		viewData->isPrewarmed = prewarm;
+		viewData->hiddenSince = std::chrono::steady_clock::now();
 		viewData->domReadyCallback = onDomReadyCallback;
+		viewData->sessionName = sessionName;
+		viewData->persistentSession = persistentSession;
 
+		int order = 0;
 		{
 			std::unique_lock lock(viewsMutex);
+			if (prewarm && !CanPrewarmLocked(htmlPath)) {
+				return 0;
+			}
+
 			int maxOrder = -1;
 			if (views.empty()) {
 				viewData->order = 0;
@@ -52,14 +100,46 @@ namespace PrismaUI::ViewManager {
 				}
 				viewData->order = maxOrder + 1;
 			}
+			order = viewData->order;
 			views[newViewId] = viewData;
+			ConsoleRouter::RegisterView(newViewId, htmlPath);
+			// Set before publishing, so the UI thread cannot create the view ahead of its prefetch.
+			viewData->prefetchPending = fileUrl != htmlPath && AssetPrefetcher::IsEnabled();
+			PublishViewSnapshot();
 		}
 
-		logger::info("View [{}] creation requested for path: {} with order <{}>. Actual view will be created by UI thread.", newViewId, fileUrl, viewData->order);
+		if (viewData->prefetchPending.load()) {
+			AssetPrefetcher::Prefetch(viewData, htmlPath);
+		}
+
+		logger::info("View [{}] {} requested for path: {} with order <{}>. Actual view will be created by UI thread.", newViewId, prewarm ? "prewarm" : "creation", fileUrl, order);
 
 		return newViewId;
 	}
 
+	Core::PrismaViewId Create(const std::string& htmlPath, std::function<void(Core::PrismaViewId)> onDomReadyCallback) {
+		EnsureCoreInitialized();
+		return CreateInternal(htmlPath, onDomReadyCallback, false);
+	}
+
+	Core::PrismaViewId CreateInSession(const std::string& htmlPath, const std::string& sessionName, bool persistent, std::function<void(Core::PrismaViewId)> onDomReadyCallback) {
+		std::string sanitizedName = SanitizeSessionName(sessionName);
+		if (sanitizedName.empty()) {
+			logger::warn("CreateInSession: Invalid session name '{}', using the default session.", sessionName);
+		}
+		else if (sanitizedName != sessionName) {
+			logger::warn("CreateInSession: Session name '{}' sanitized to '{}'.", sessionName, sanitizedName);
+		}
+
+		EnsureCoreInitialized();
+		return CreateInternal(htmlPath, onDomReadyCallback, false, sanitizedName, persistent);
+	}
+
+	Core::PrismaViewId Prewarm(const std::string& htmlPath, std::function<void(Core::PrismaViewId)> onDomReadyCallback) {
+		EnsureCoreInitialized();
+		return CreateInternal(htmlPath, onDomReadyCallback, true);
+	}
+
 	// Helper function to perform unfocus operations (used by Hide, Unfocus, and Focus)
 	// closeFocusMenu: whether to close FocusMenu (false when switching focus between views)
 	static void PerformUnfocusOperations(const Core::PrismaViewId& viewId, std::shared_ptr<PrismaView> viewData, bool closeFocusMenu = true) {
@@ -92,65 +172,192 @@ namespace PrismaUI::ViewManager {
 		controlMap->ToggleControls(RE::UserEvents::USER_EVENT_FLAG::kVATS, true);
 	}
 
-	void Show(const Core::PrismaViewId& viewId) {
-		if (!ViewManager::IsValid(viewId)) {
-			logger::warn("Show: View ID [{}] not found.", viewId);
+	// Helper function to move a view in or out of hibernation, must run on the UI thread.
+	static void SetHibernationState(const Core::PrismaViewId& viewId, std::shared_ptr<PrismaView> viewData, bool hibernate) {
+		if (!viewData || !viewData->ultralightView) {
+			return;
+		}
+
+		viewData->ultralightView->set_display_id(hibernate ? HIBERNATED_DISPLAY_ID : ACTIVE_DISPLAY_ID);
+
+		if (viewData->isLoadingFinished) {
+			viewData->ultralightView->EvaluateScript(hibernate ?
+				"document.dispatchEvent(new Event('prismaui:hibernate'));" :
+				"document.dispatchEvent(new Event('prismaui:resume'));", nullptr, "");
+		}
+
+		if (!hibernate) {
+			viewData->ultralightView->set_needs_paint(true);
+		}
+
+		viewData->isHibernated = hibernate;
+		logger::debug("View [{}] {} hibernation.", viewId, hibernate ? "entered" : "left");
+	}
+
+	static void ApplyShow(const Core::PrismaViewId& viewId, const std::shared_ptr<PrismaView>& viewData) {
+		if (!viewData->isHidden.load()) {
+			logger::debug("Show: View [{}] is already visible.", viewId);
+			return;
+		}
+		if (viewData->isHibernated.load()) {
+			SetHibernationState(viewId, viewData, false);
+		}
+		viewData->isPrewarmed = false;
+		viewData->isHidden = false;
+		logger::debug("View [{}] marked as Visible.", viewId);
+	}
+
+	static void ApplyHide(const Core::PrismaViewId& viewId, const std::shared_ptr<PrismaView>& viewData) {
+		if (viewData->isHidden.load()) {
+			logger::debug("Hide: View [{}] is already hidden.", viewId);
+			return;
+		}
+
+		// If view has focus, unfocus it first
+		if (viewData->ultralightView && viewData->ultralightView->HasFocus()) {
+			PerformUnfocusOperations(viewId, viewData);
+			logger::debug("Hide: View [{}] was focused, unfocused it.", viewId);
+		}
+
+		viewData->hiddenSince = std::chrono::steady_clock::now();
+		viewData->isHidden = true;
+		logger::debug("View [{}] marked as Hidden.", viewId);
+	}
+
+	static void ApplyFocus(const Core::PrismaViewId& viewId, const std::shared_ptr<PrismaView>& viewData, bool pauseGame) {
+		if (!viewData->ultralightView) {
+			logger::warn("Focus: View [{}] or its Ultralight View is not ready.", viewId);
 			return;
 		}
 
-		ViewOperationQueue::EnqueueOperation(viewId, [viewId]() {
-			std::shared_ptr<PrismaView> viewData = nullptr;
-			{
-				std::shared_lock lock(viewsMutex);
-				auto it = views.find(viewId);
-				if (it != views.end()) {
-					viewData = it->second;
+		if (viewData->isHidden.load()) {
+			logger::warn("Focus: View [{}] is hidden, cannot focus.", viewId);
+			return;
+		}
+
+		if (viewData->ultralightView->HasFocus()) {
+			logger::debug("Focus: View [{}] already has focus.", viewId);
+			return;
+		}
+
+		// Unfocus other views
+		std::vector<Core::PrismaViewId> viewsToUnfocus;
+		{
+			std::shared_lock lock(viewsMutex);
+			for (const auto& pair : views) {
+				if (pair.first != viewId && pair.second->ultralightView && pair.second->ultralightView->HasFocus()) {
+					viewsToUnfocus.push_back(pair.first);
 				}
 			}
+		}
+
+		for (const auto& idToUnfocus : viewsToUnfocus) {
+			// Don't close FocusMenu when switching focus between views
+			ViewOperationQueue::EnqueueOperation(idToUnfocus, { ViewOperationQueue::OperationType::Unfocus, false });
+		}
+
+		// Focus this view
+		viewData->ultralightView->Focus();
+		PrismaUI::InputHandler::EnableInputCapture(viewId);
+		FocusMenu::Open();
+
+		auto controlMap = RE::ControlMap::GetSingleton();
+		controlMap->ToggleControls(RE::UserEvents::USER_EVENT_FLAG::kWheelZoom, false);
+		controlMap->ToggleControls(RE::UserEvents::USER_EVENT_FLAG::kLooking, false);
+		controlMap->ToggleControls(RE::UserEvents::USER_EVENT_FLAG::kJumping, false);
+		controlMap->ToggleControls(RE::UserEvents::USER_EVENT_FLAG::kMovement, false);
+		controlMap->ToggleControls(RE::UserEvents::USER_EVENT_FLAG::kActivate, false);
+		controlMap->ToggleControls(RE::UserEvents::USER_EVENT_FLAG::kPOVSwitch, false);
+		controlMap->ToggleControls(RE::UserEvents::USER_EVENT_FLAG::kVATS, false);
+
+		if (pauseGame) {
+			auto ui = RE::UI::GetSingleton();
+			if (ui) {
+				ui->numPausesGame++;
+				viewData->isPaused.store(true);
+				logger::debug("Game paused for View [{}]", viewId);
+			}
+		}
+
+		logger::debug("Focus: View [{}] focused successfully.", viewId);
+	}
 
-			if (viewData) {
-				if (!viewData->isHidden.load()) {
-					logger::debug("Show: View [{}] is already visible.", viewId);
-					return;
+	static void ApplyUnfocus(const Core::PrismaViewId& viewId, const std::shared_ptr<PrismaView>& viewData, bool closeFocusMenu) {
+		if (!viewData->ultralightView) {
+			logger::warn("Unfocus: View [{}] Ultralight View is not ready.", viewId);
+			if (viewData->isPaused.load()) {
+				auto ui = RE::UI::GetSingleton();
+				if (ui && ui->numPausesGame > 0) {
+					ui->numPausesGame--;
 				}
-				viewData->isHidden = false;
-				logger::debug("View [{}] marked as Visible.", viewId);
+				viewData->isPaused.store(false);
 			}
-		});
+			PrismaUI::InputHandler::DisableInputCapture(viewId);
+			FocusMenu::Close();
+			return;
+		}
+
+		if (!viewData->ultralightView->HasFocus()) {
+			logger::debug("Unfocus: View [{}] does not have focus.", viewId);
+			return;
+		}
+
+		PerformUnfocusOperations(viewId, viewData, closeFocusMenu);
+		logger::debug("Unfocus: View [{}] unfocused {}.", viewId, closeFocusMenu ? "successfully" : "(focus switching)");
 	}
 
-	void Hide(const Core::PrismaViewId& viewId) {
-		if (!ViewManager::IsValid(viewId)) {
-			logger::warn("Hide: View ID [{}] not found.", viewId);
+	static void ApplyHibernate(const Core::PrismaViewId& viewId, const std::shared_ptr<PrismaView>& viewData) {
+		if (viewData->isHibernated.load()) {
+			logger::debug("Hibernate: View [{}] is already hibernated.", viewId);
 			return;
 		}
 
-		ViewOperationQueue::EnqueueOperation(viewId, [viewId]() {
-			std::shared_ptr<PrismaView> viewData = nullptr;
-			{
-				std::shared_lock lock(viewsMutex);
-				auto it = views.find(viewId);
-				if (it != views.end()) {
-					viewData = it->second;
-				}
-			}
+		if (!viewData->ultralightView) {
+			logger::warn("Hibernate: View [{}] Ultralight View is not ready.", viewId);
+			return;
+		}
 
-			if (viewData) {
-				if (viewData->isHidden.load()) {
-					logger::debug("Hide: View [{}] is already hidden.", viewId);
-					return;
-				}
+		if (viewData->ultralightView->HasFocus()) {
+			PerformUnfocusOperations(viewId, viewData);
+			logger::debug("Hibernate: View [{}] was focused, unfocused it.", viewId);
+		}
 
-				// If view has focus, unfocus it first
-				if (viewData->ultralightView && viewData->ultralightView->HasFocus()) {
-					PerformUnfocusOperations(viewId, viewData);
-					logger::debug("Hide: View [{}] was focused, unfocused it.", viewId);
-				}
+		if (!viewData->isHidden.load()) {
+			viewData->hiddenSince = std::chrono::steady_clock::now();
+			viewData->isHidden = true;
+		}
 
-				viewData->isHidden = true;
-				logger::debug("View [{}] marked as Hidden.", viewId);
-			}
-		});
+		SetHibernationState(viewId, viewData, true);
+	}
+
+	void ApplyOperation(const std::shared_ptr<PrismaView>& viewData, const ViewOperationQueue::Operation& operation) {
+		using ViewOperationQueue::OperationType;
+
+		switch (operation.type) {
+		case OperationType::Show: ApplyShow(viewData->id, viewData); break;
+		case OperationType::Hide: ApplyHide(viewData->id, viewData); break;
+		case OperationType::Focus: ApplyFocus(viewData->id, viewData, operation.flag); break;
+		case OperationType::Unfocus: ApplyUnfocus(viewData->id, viewData, operation.flag); break;
+		case OperationType::Hibernate: ApplyHibernate(viewData->id, viewData); break;
+		}
+	}
+
+	void Show(const Core::PrismaViewId& viewId) {
+		if (!ViewManager::IsValid(viewId)) {
+			logger::warn("Show: View ID [{}] not found.", viewId);
+			return;
+		}
+
+		ViewOperationQueue::EnqueueOperation(viewId, { ViewOperationQueue::OperationType::Show });
+	}
+
+	void Hide(const Core::PrismaViewId& viewId) {
+		if (!ViewManager::IsValid(viewId)) {
+			logger::warn("Hide: View ID [{}] not found.", viewId);
+			return;
+		}
+
+		ViewOperationQueue::EnqueueOperation(viewId, { ViewOperationQueue::OperationType::Hide });
 	}
 
 	bool IsHidden(const Core::PrismaViewId& viewId) {
@@ -174,86 +381,7 @@ namespace PrismaUI::ViewManager {
 			return false;
 		}
 
-		ViewOperationQueue::EnqueueOperation(viewId, [viewId, pauseGame]() {
-			std::shared_ptr<PrismaView> viewData = nullptr;
-			{
-				std::shared_lock lock(viewsMutex);
-				auto it = views.find(viewId);
-				if (it != views.end()) {
-					viewData = it->second;
-				}
-			}
-
-			if (!viewData || !viewData->ultralightView) {
-				logger::warn("Focus: View [{}] or its Ultralight View is not ready.", viewId);
-				return;
-			}
-
-			if (viewData->isHidden.load()) {
-				logger::warn("Focus: View [{}] is hidden, cannot focus.", viewId);
-				return;
-			}
-
-			if (viewData->ultralightView->HasFocus()) {
-				logger::debug("Focus: View [{}] already has focus.", viewId);
-				return;
-			}
-
-			// Unfocus other views
-			std::vector<Core::PrismaViewId> viewsToUnfocus;
-			{
-				std::shared_lock lock(viewsMutex);
-				for (const auto& pair : views) {
-					if (pair.first != viewId && pair.second->ultralightView && pair.second->ultralightView->HasFocus()) {
-						viewsToUnfocus.push_back(pair.first);
-					}
-				}
-			}
-
-			for (const auto& idToUnfocus : viewsToUnfocus) {
-				ViewOperationQueue::EnqueueOperation(idToUnfocus, [idToUnfocus]() {
-					std::shared_ptr<PrismaView> vd = nullptr;
-					{
-						std::shared_lock lock(viewsMutex);
-						auto it = views.find(idToUnfocus);
-						if (it != views.end()) {
-							vd = it->second;
-						}
-					}
-
-					if (vd && vd->ultralightView) {
-						// Don't close FocusMenu when switching focus between views
-						PerformUnfocusOperations(idToUnfocus, vd, false);
-						logger::debug("Unfocus: View [{}] unfocused (focus switching).", idToUnfocus);
-					}
-				});
-			}
-
-			// Focus this view
-			viewData->ultralightView->Focus();
-			PrismaUI::InputHandler::EnableInputCapture(viewId);
-			FocusMenu::Open();
-
-			auto controlMap = RE::ControlMap::GetSingleton();
-			controlMap->ToggleControls(RE::UserEvents::USER_EVENT_FLAG::kWheelZoom, false);
-			controlMap->ToggleControls(RE::UserEvents::USER_EVENT_FLAG::kLooking, false);
-			controlMap->ToggleControls(RE::UserEvents::USER_EVENT_FLAG::kJumping, false);
-			controlMap->ToggleControls(RE::UserEvents::USER_EVENT_FLAG::kMovement, false);
-			controlMap->ToggleControls(RE::UserEvents::USER_EVENT_FLAG::kActivate, false);
-			controlMap->ToggleControls(RE::UserEvents::USER_EVENT_FLAG::kPOVSwitch, false);
-			controlMap->ToggleControls(RE::UserEvents::USER_EVENT_FLAG::kVATS, false);
-
-			if (pauseGame) {
-				auto ui = RE::UI::GetSingleton();
-				if (ui) {
-					ui->numPausesGame++;
-					viewData->isPaused.store(true);
-					logger::debug("Game paused for View [{}]", viewId);
-				}
-			}
-
-			logger::debug("Focus: View [{}] focused successfully.", viewId);
-		});
+		ViewOperationQueue::EnqueueOperation(viewId, { ViewOperationQueue::OperationType::Focus, pauseGame });
 
 		return true;
 	}
@@ -264,56 +392,11 @@ namespace PrismaUI::ViewManager {
 			return;
 		}
 
-		ViewOperationQueue::EnqueueOperation(viewId, [viewId]() {
-			std::shared_ptr<PrismaView> viewData = nullptr;
-			{
-				std::shared_lock lock(viewsMutex);
-				auto it = views.find(viewId);
-				if (it != views.end()) {
-					viewData = it->second;
-				}
-			}
-
-			if (!viewData) {
-				logger::warn("Unfocus: View [{}] not found during operation execution.", viewId);
-				PrismaUI::InputHandler::DisableInputCapture(0);
-				FocusMenu::Close();
-				return;
-			}
-
-			if (!viewData->ultralightView) {
-				logger::warn("Unfocus: View [{}] Ultralight View is not ready.", viewId);
-				if (viewData->isPaused.load()) {
-					auto ui = RE::UI::GetSingleton();
-					if (ui && ui->numPausesGame > 0) {
-						ui->numPausesGame--;
-					}
-					viewData->isPaused.store(false);
-				}
-				PrismaUI::InputHandler::DisableInputCapture(viewId);
-				FocusMenu::Close();
-				return;
-			}
-
-			if (!viewData->ultralightView->HasFocus()) {
-				logger::debug("Unfocus: View [{}] does not have focus.", viewId);
-				return;
-			}
-
-			PerformUnfocusOperations(viewId, viewData);
-			logger::debug("Unfocus: View [{}] unfocused successfully.", viewId);
-		});
+		ViewOperationQueue::EnqueueOperation(viewId, { ViewOperationQueue::OperationType::Unfocus, true });
 	}
 
 	bool HasFocus(const Core::PrismaViewId& viewId) {
-		std::shared_ptr<PrismaView> viewData = nullptr;
-		{
-			std::shared_lock lock(viewsMutex);
-			auto it = views.find(viewId);
-			if (it != views.end()) {
-				viewData = it->second;
-			}
-		}
+		std::shared_ptr<PrismaView> viewData = FindView(viewId);
 
 		if (viewData) {
 			auto future = ultralightThread.submit([view_ptr = viewData->ultralightView]() -> bool {
@@ -334,14 +417,7 @@ namespace PrismaUI::ViewManager {
 	}
 
 	bool ViewHasInputFocus(const Core::PrismaViewId& viewId) {
-		std::shared_ptr<PrismaView> viewData = nullptr;
-		{
-			std::shared_lock lock(viewsMutex);
-			auto it = views.find(viewId);
-			if (it != views.end()) {
-				viewData = it->second;
-			}
-		}
+		std::shared_ptr<PrismaView> viewData = FindView(viewId);
 
 		if (viewData && viewData->ultralightView) {
 			auto future = ultralightThread.submit([view_ptr = viewData->ultralightView]() -> bool {
@@ -389,57 +465,35 @@ namespace PrismaUI::ViewManager {
 		return 28;
 	}
 
-	void Destroy(const Core::PrismaViewId& viewId) {
+	void Destroy(const Core::PrismaViewId& viewId, std::function<void(Core::PrismaViewId)> onDestroyed) {
 		logger::info("Destroy: Beginning destruction of View [{}]", viewId);
 
-		if (!ViewManager::IsValid(viewId)) {
-			logger::warn("Destroy: View ID [{}] not found.", viewId);
-			return;
-		}
-
 		// Clear pending operations for this view to prevent execution after destruction
 		ViewOperationQueue::ClearOperations(viewId);
-		logger::debug("Destroy: Cleared pending operations for View [{}]", viewId);
-
-		if (HasFocus(viewId)) {
-			logger::debug("Destroy: View [{}] has focus, unfocusing first.", viewId);
-			Unfocus(viewId);
-		}
 
 		std::shared_ptr<PrismaView> viewDataToDestroy = nullptr;
 		{
 			std::unique_lock lock(viewsMutex);
 			auto it = views.find(viewId);
-			if (it != views.end()) {
-				viewDataToDestroy = std::move(it->second);
-				views.erase(it);
-				logger::debug("Destroy: Removed View [{}] from views map", viewId);
-			}
-			else {
-				logger::warn("Destroy: View ID [{}] not found after checking validity.", viewId);
+			if (it == views.end()) {
+				logger::warn("Destroy: View ID [{}] not found.", viewId);
 				return;
 			}
+			viewDataToDestroy = std::move(it->second);
+			views.erase(it);
+			PublishViewSnapshot();
 		}
 
+		// From here on the view is invalid to the API and no longer drawn, even from a snapshot taken earlier.
 		viewDataToDestroy->isHidden = true;
-		logger::debug("Destroy: Marked View [{}] as hidden", viewId);
+		logger::debug("Destroy: Removed View [{}] from views map", viewId);
 
 		{
 			std::lock_guard<std::mutex> lock(jsCallbacksMutex);
-			logger::debug("Destroy: Removing JavaScript callbacks for View [{}]", viewId);
 
-			auto it = jsCallbacks.begin();
-			size_t removedCallbacks = 0;
-
-			while (it != jsCallbacks.end()) {
-				if (it->first.first == viewId) {
-					it = jsCallbacks.erase(it);
-					removedCallbacks++;
-				}
-				else {
-					++it;
-				}
-			}
+			size_t removedCallbacks = std::erase_if(jsCallbacks, [&viewId](const auto& pair) {
+				return pair.first.first == viewId;
+				});
 
 			if (removedCallbacks > 0) {
 				logger::debug("Destroy: Removed {} JavaScript callback(s) for View [{}]",
@@ -447,13 +501,18 @@ namespace PrismaUI::ViewManager {
 			}
 		}
 
-		logger::debug("Destroy: Cleaning up Ultralight resources (on UI thread) for View [{}]", viewId);
-		auto ultralightCleanupFuture = ultralightThread.submit([viewId, viewData = viewDataToDestroy]() {
+		// Ultralight teardown on the UI thread, then the textures on the render thread, see ViewRenderer::DeferRelease.
+		// The caller does not wait for either.
+		ultralightThread.submit_ordered(TaskPriority::Render, viewId, [viewId, viewData = std::move(viewDataToDestroy), onDestroyed = std::move(onDestroyed)]() mutable {
 			try {
-				logger::debug("Destroy: Beginning Ultralight resources cleanup for View [{}]", viewId);
+				ScriptScheduler::DropScripts(viewData);
 
 				if (viewData->ultralightView) {
-					logger::debug("Destroy: Detaching listeners for View [{}]", viewId);
+					if (viewData->ultralightView->HasFocus()) {
+						logger::debug("Destroy: View [{}] has focus, unfocusing first.", viewId);
+						PerformUnfocusOperations(viewId, viewData);
+					}
+
 					viewData->ultralightView->set_load_listener(nullptr);
 					viewData->ultralightView->set_view_listener(nullptr);
 
@@ -464,82 +523,36 @@ namespace PrismaUI::ViewManager {
 					logger::debug("Destroy: Ultralight View object released for View [{}]", viewId);
 				}
 
+				ConsoleRouter::RemoveView(viewId);
+
 				{
 					std::lock_guard lock(viewData->bufferMutex);
-					viewData->pixelBuffer.clear();
-					viewData->pixelBuffer.shrink_to_fit();
+					viewData->pixelBuffer.release();
 					viewData->bufferWidth = 0;
 					viewData->bufferHeight = 0;
 					viewData->bufferStride = 0;
-					logger::debug("Destroy: Pixel buffer cleared for View [{}]", viewId);
 				}
 
 				viewData->isLoadingFinished = false;
 				viewData->newFrameReady = false;
-
-				logger::debug("Destroy: Ultralight resources for View [{}] cleaned up successfully", viewId);
-
-				return true;
 			}
 			catch (const std::exception& e) {
 				logger::error("Destroy: Exception during Ultralight resource cleanup for View [{}]: {}", viewId, e.what());
-				return false;
 			}
 			catch (...) {
 				logger::error("Destroy: Unknown exception during Ultralight resource cleanup for View [{}]", viewId);
-				return false;
 			}
-			});
-
-		try {
-			bool ultralight_success = ultralightCleanupFuture.get();
-			if (ultralight_success) {
-				logger::debug("Destroy: Ultralight resources cleanup completed successfully for View [{}]", viewId);
-			}
-			else {
-				logger::warn("Destroy: Ultralight resources cleanup reported failure for View [{}]", viewId);
-			}
-		}
-		catch (const std::exception& e) {
-			logger::error("Destroy: Exception waiting for Ultralight cleanup for View [{}]: {}", viewId, e.what());
-		}
-
-		bool hasD3DResources = (viewDataToDestroy->texture != nullptr || viewDataToDestroy->textureView != nullptr);
-
-		if (hasD3DResources) {
-			logger::debug("Destroy: D3D resources present for View [{}], forcing manual cleanup", viewId);
-
-			if (viewDataToDestroy->textureView) {
-				logger::debug("Destroy: Releasing textureView for View [{}]", viewId);
-				viewDataToDestroy->textureView->Release();
-				viewDataToDestroy->textureView = nullptr;
-			}
-
-			if (viewDataToDestroy->texture) {
-				logger::debug("Destroy: Releasing texture for View [{}]", viewId);
-				viewDataToDestroy->texture->Release();
-				viewDataToDestroy->texture = nullptr;
-			}
-
-			viewDataToDestroy->textureWidth = 0;
-			viewDataToDestroy->textureHeight = 0;
-
-			logger::debug("Destroy: D3D resources released for View [{}]", viewId);
-		}
-		else {
-			logger::debug("Destroy: No D3D resources to release for View [{}]", viewId);
-		}
-
-		viewDataToDestroy->pendingResourceRelease = false;
 
-		logger::info("Destroy: View [{}] successfully destroyed", viewId);
+			ViewRenderer::DeferRelease(std::move(viewData), std::move(onDestroyed));
+			});
 	}
 
 	void SetOrder(const Core::PrismaViewId& viewId, int order) {
-		std::shared_lock lock(viewsMutex);
+		std::unique_lock lock(viewsMutex);
 		auto it = views.find(viewId);
 		if (it != views.end()) {
 			it->second->order = order;
+			PublishViewSnapshot();
 			logger::debug("SetOrder: Set order {} for view [{}]", order, viewId);
 		}
 		else {
@@ -556,4 +569,40 @@ namespace PrismaUI::ViewManager {
 		logger::warn("GetOrder: View ID [{}] not found, returning -1.", viewId);
 		return -1;
 	}
+
+	void Hibernate(const Core::PrismaViewId& viewId) {
+		if (!ViewManager::IsValid(viewId)) {
+			logger::warn("Hibernate: View ID [{}] not found.", viewId);
+			return;
+		}
+
+		ViewOperationQueue::EnqueueOperation(viewId, { ViewOperationQueue::OperationType::Hibernate });
+	}
+
+	bool IsHibernated(const Core::PrismaViewId& viewId) {
+		std::shared_lock lock(viewsMutex);
+		auto it = views.find(viewId);
+		if (it != views.end()) {
+			return it->second->isHibernated.load();
+		}
+		logger::warn("IsHibernated: View ID [{}] not found.", viewId);
+		return false;
+	}
+
+	void SetCreationPriority(const Core::PrismaViewId& viewId, int priority) {
+		std::shared_lock lock(viewsMutex);
+		auto it = views.find(viewId);
+		if (it == views.end()) {
+			logger::warn("SetCreationPriority: View ID [{}] not found.", viewId);
+			return;
+		}
+
+		if (it->second->isCreated.load()) {
+			logger::debug("SetCreationPriority: View [{}] is already created, priority ignored.", viewId);
+			return;
+		}
+
+		it->second->creationPriority = priority;
+		logger::debug("SetCreationPriority: Set creation priority {} for view [{}]", priority, viewId);
+	}
 }
@@ -8,12 +8,24 @@
 
 namespace PrismaUI::Core {
 	typedef uint64_t PrismaViewId;
+	struct PrismaView;
+}
+
+namespace PrismaUI::ViewOperationQueue {
+	struct Operation;
 }
 
 namespace PrismaUI::ViewManager {
 	using namespace ultralight;
 
+	// Hibernated views are moved to a display that is never refreshed, which freezes their
+	// requestAnimationFrame callbacks and CSS animations.
+	constexpr uint32_t ACTIVE_DISPLAY_ID = 0;
+	constexpr uint32_t HIBERNATED_DISPLAY_ID = 1;
+
 	Core::PrismaViewId Create(const std::string& htmlPath, std::function<void(Core::PrismaViewId)> onDomReadyCallback = nullptr);
+	Core::PrismaViewId CreateInSession(const std::string& htmlPath, const std::string& sessionName, bool persistent, std::function<void(Core::PrismaViewId)> onDomReadyCallback = nullptr);
+	Core::PrismaViewId Prewarm(const std::string& htmlPath, std::function<void(Core::PrismaViewId)> onDomReadyCallback = nullptr);
 	void Show(const Core::PrismaViewId& viewId);
 	void Hide(const Core::PrismaViewId& viewId);
 	bool IsHidden(const Core::PrismaViewId& viewId);
@@ -21,10 +33,18 @@ namespace PrismaUI::ViewManager {
 	void Unfocus(const Core::PrismaViewId& viewId);
 	bool HasFocus(const Core::PrismaViewId& viewId);
 	bool ViewHasInputFocus(const Core::PrismaViewId& viewId);
-	void Destroy(const Core::PrismaViewId& viewId);
+	// Returns at once: the view is invalid right away, Ultralight and GPU resources are released over the next frames.
+	// onDestroyed runs on the render thread once everything has been released.
+	void Destroy(const Core::PrismaViewId& viewId, std::function<void(Core::PrismaViewId)> onDestroyed = nullptr);
 	bool IsValid(const Core::PrismaViewId& viewId);
 	void SetScrollingPixelSize(const Core::PrismaViewId& viewId, int pixelSize);
 	int GetScrollingPixelSize(const Core::PrismaViewId& viewId);
 	void SetOrder(const Core::PrismaViewId& viewId, int order);
 	int GetOrder(const Core::PrismaViewId& viewId);
+	void Hibernate(const Core::PrismaViewId& viewId);
+	bool IsHibernated(const Core::PrismaViewId& viewId);
+	void SetCreationPriority(const Core::PrismaViewId& viewId, int priority);
+
+	// Executes a queued Show/Hide/Focus/Unfocus/Hibernate. UI thread only, see ViewOperationQueue.
+	void ApplyOperation(const std::shared_ptr<Core::PrismaView>& viewData, const ViewOperationQueue::Operation& operation);
 }
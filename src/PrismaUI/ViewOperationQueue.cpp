@@ -1,146 +1,146 @@
-#include "ViewOperationQueue.h"
+﻿#include "ViewOperationQueue.h"
 #include "Core.h"
+#include "ViewManager.h"
+#include "ViewOperationReducer.h"
+
+#include <Utils/DeferredLog/DeferredLog.h>
+
+#include <algorithm>
 
 namespace PrismaUI::ViewOperationQueue {
 	using namespace Core;
 
-	bool EnqueueOperation(Core::PrismaViewId viewId, OperationFunc operation) {
-		if (!operation) {
-			logger::error("EnqueueOperation: Attempted to enqueue null operation for view [{}]", viewId);
-			return false;
+	// Operations queued by other operations (focus switching unfocuses the previous view) run in
+	// a further pass of the same drain, up to this many passes.
+	static constexpr int MAX_DRAIN_PASSES = 4;
+
+	static std::atomic<bool> drainScheduled = false;
+
+	static const char* OperationName(OperationType type) {
+		switch (type) {
+		case OperationType::Show: return "Show";
+		case OperationType::Hide: return "Hide";
+		case OperationType::Focus: return "Focus";
+		case OperationType::Unfocus: return "Unfocus";
+		case OperationType::Hibernate: return "Hibernate";
+		default: return "Unknown";
 		}
+	}
 
-		std::shared_ptr<PrismaView> viewData = nullptr;
-		{
-			std::shared_lock lock(viewsMutex);
-			auto it = views.find(viewId);
-			if (it != views.end()) {
-				viewData = it->second;
-			}
+	// Replaces the foldable tail of the ring plus operation with the shortest equivalent sequence.
+	// folded receives how many operations disappeared.
+	static bool FoldIntoQueue(OperationRing& ring, const Operation& operation, size_t& folded) {
+		using namespace ViewOperationReducer;
+
+		Symbol symbol = ToSymbol(operation);
+		if (IsBarrier(symbol)) {
+			return ring.push(operation);
+		}
+
+		// The tail is kept folded, so it never grows past MAX_FOLDED_LENGTH.
+		std::array<Symbol, MAX_FOLDED_LENGTH> tail{};
+		size_t tailLength = 0;
+		while (tailLength < MAX_FOLDED_LENGTH && !ring.empty() && !IsBarrier(ToSymbol(ring.back()))) {
+			tail[tailLength++] = ToSymbol(ring.back());
+			ring.pop_back();
+		}
+		std::reverse(tail.begin(), tail.begin() + tailLength);
+
+		std::array<Symbol, MAX_FOLDED_LENGTH + 1> result{};
+		size_t resultLength = Fold(tail.data(), tailLength, symbol, result.data());
+		for (size_t i = 0; i < resultLength; ++i) {
+			if (!ring.push(ToOperation(result[i]))) return false;
 		}
 
+		folded = tailLength + 1 - resultLength;
+		return true;
+	}
+
+	bool EnqueueOperation(Core::PrismaViewId viewId, Operation operation) {
+		std::shared_ptr<PrismaView> viewData = FindView(viewId);
+
 		if (!viewData) {
-			logger::warn("EnqueueOperation: View [{}] not found, operation discarded", viewId);
+			DeferredLog::warn("EnqueueOperation: View [{}] not found, {} discarded", viewId, OperationName(operation.type));
 			return false;
 		}
 
 		{
 			std::lock_guard lock(viewData->operationMutex);
-			
-			if (viewData->pendingOperations.size() >= MAX_OPERATIONS_PER_VIEW) {
-				logger::error("EnqueueOperation: Queue overflow for view [{}]. Max size: {}. Operation discarded.",
-					viewId, MAX_OPERATIONS_PER_VIEW);
+			auto& ring = viewData->pendingOperations;
+
+			size_t folded = 0;
+			bool queued = FoldIntoQueue(ring, operation, folded);
+			viewData->queuedOperationsCount.store(static_cast<int>(ring.size()), std::memory_order_relaxed);
+
+			if (!queued) {
+				DeferredLog::error("EnqueueOperation: Queue overflow for view [{}]. Max size: {}. {} discarded.",
+					viewId, MAX_OPERATIONS_PER_VIEW, OperationName(operation.type));
 				return false;
 			}
 
-			viewData->pendingOperations.push(std::move(operation));
-			viewData->queuedOperationsCount.fetch_add(1, std::memory_order_relaxed);
-			
-			logger::debug("EnqueueOperation: Operation enqueued for view [{}]. Queue size: {}",
-				viewId, viewData->pendingOperations.size());
+			DeferredLog::debug("EnqueueOperation: {} enqueued for view [{}]. Queue size: {}, folded away: {}",
+				OperationName(operation.type), viewId, ring.size(), folded);
 		}
 
 		return true;
 	}
 
-	void ProcessNextOperation(Core::PrismaViewId viewId) {
-		std::shared_ptr<PrismaView> viewData = nullptr;
-		{
-			std::shared_lock lock(viewsMutex);
-			auto it = views.find(viewId);
-			if (it != views.end()) {
-				viewData = it->second;
-			}
-		}
-
-		if (!viewData) {
-			return;
-		}
-
-		bool expected = false;
-		if (!viewData->isProcessingOperation.compare_exchange_strong(expected, true, 
-			std::memory_order_acquire, std::memory_order_relaxed)) {
-			return;
-		}
-
-		OperationFunc operation;
+	// Executes every operation queued for the view when called, returns how many ran.
+	static size_t DrainView(const std::shared_ptr<PrismaView>& viewData) {
+		std::array<Operation, MAX_OPERATIONS_PER_VIEW> batch;
+		size_t batchSize = 0;
 		{
 			std::lock_guard lock(viewData->operationMutex);
-			if (viewData->pendingOperations.empty()) {
-				viewData->isProcessingOperation.store(false, std::memory_order_release);
-				return;
+			while (viewData->pendingOperations.pop(batch[batchSize])) {
+				batchSize++;
 			}
-
-			operation = std::move(viewData->pendingOperations.front());
-			viewData->pendingOperations.pop();
-			viewData->queuedOperationsCount.fetch_sub(1, std::memory_order_relaxed);
-			
-			logger::debug("ProcessNextOperation: Processing operation for view [{}]. Remaining in queue: {}",
-				viewId, viewData->pendingOperations.size());
+			viewData->queuedOperationsCount.store(0, std::memory_order_relaxed);
 		}
 
-		ultralightThread.submit([viewId, op = std::move(operation)]() {
+		for (size_t i = 0; i < batchSize; ++i) {
 			try {
-				{
-					std::shared_lock lock(viewsMutex);
-					auto it = views.find(viewId);
-					if (it == views.end()) {
-						logger::warn("ProcessNextOperation: View [{}] was destroyed before operation execution", viewId);
-						return;
-					}
-				}
-
-				op();
-				
-				logger::debug("ProcessNextOperation: Operation completed for view [{}]", viewId);
+				ViewManager::ApplyOperation(viewData, batch[i]);
+				DeferredLog::debug("ProcessAllViewOperations: {} completed for view [{}]", OperationName(batch[i].type), viewData->id);
 			}
 			catch (const std::exception& e) {
-				logger::error("ProcessNextOperation: Exception during operation execution for view [{}]: {}", 
-					viewId, e.what());
+				DeferredLog::error("ProcessAllViewOperations: Exception during {} for view [{}]: {}",
+					OperationName(batch[i].type), viewData->id, e.what());
 			}
 			catch (...) {
-				logger::error("ProcessNextOperation: Unknown exception during operation execution for view [{}]", viewId);
-			}
-
-			std::shared_ptr<PrismaView> vd = nullptr;
-			{
-				std::shared_lock lock(viewsMutex);
-				auto it = views.find(viewId);
-				if (it != views.end()) {
-					vd = it->second;
-				}
+				DeferredLog::error("ProcessAllViewOperations: Unknown exception during {} for view [{}]", OperationName(batch[i].type), viewData->id);
 			}
+		}
+		return batchSize;
+	}
 
-			if (vd) {
-				vd->isProcessingOperation.store(false, std::memory_order_release);
-			}
-		});
+	static bool AnyOperationQueued(const ViewSnapshot& snapshot) {
+		return std::any_of(snapshot.slots.begin(), snapshot.slots.end(), [](ViewSlot slot) {
+			return frameTable.queuedOperationsCount[slot].load(std::memory_order_relaxed) > 0;
+			});
 	}
 
-	void ProcessAllViewOperations() {
-		std::vector<Core::PrismaViewId> viewIds;
-		{
-			std::shared_lock lock(viewsMutex);
-			viewIds.reserve(views.size());
-			for (const auto& pair : views) {
-				viewIds.push_back(pair.first);
+	void ProcessAllViewOperations(const Core::ViewSnapshot& snapshot) {
+		if (drainScheduled.load(std::memory_order_acquire) || !AnyOperationQueued(snapshot)) return;
+		if (drainScheduled.exchange(true, std::memory_order_acq_rel)) return;
+
+		// Ordered against every view, so no later per-view task from a higher lane runs before these operations.
+		ultralightThread.submit_ordered(TaskPriority::Render, SingleThreadExecutor::ALL_ORDER_KEYS, []() {
+			for (int pass = 0; pass < MAX_DRAIN_PASSES; ++pass) {
+				size_t drained = 0;
+				const auto snapshot = GetViewSnapshot();
+				for (const auto& viewData : snapshot->views) {
+					if (viewData->queuedOperationsCount.load(std::memory_order_relaxed) > 0) {
+						drained += DrainView(viewData);
+					}
+				}
+				if (drained == 0) break;
 			}
-		}
-
-		for (const auto& viewId : viewIds) {
-			ProcessNextOperation(viewId);
-		}
+			drainScheduled.store(false, std::memory_order_release);
+			});
 	}
 
 	void ClearOperations(Core::PrismaViewId viewId) {
-		std::shared_ptr<PrismaView> viewData = nullptr;
-		{
-			std::shared_lock lock(viewsMutex);
-			auto it = views.find(viewId);
-			if (it != views.end()) {
-				viewData = it->second;
-			}
-		}
+		std::shared_ptr<PrismaView> viewData = FindView(viewId);
 
 		if (!viewData) {
 			return;
@@ -150,29 +150,18 @@ namespace PrismaUI::ViewOperationQueue {
 		{
 			std::lock_guard lock(viewData->operationMutex);
 			clearedCount = viewData->pendingOperations.size();
-			
-			while (!viewData->pendingOperations.empty()) {
-				viewData->pendingOperations.pop();
-			}
-			
+			viewData->pendingOperations.clear();
 			viewData->queuedOperationsCount.store(0, std::memory_order_relaxed);
 		}
 
 		if (clearedCount > 0) {
-			logger::debug("ClearOperations: Cleared {} pending operation(s) for view [{}]", 
+			DeferredLog::debug("ClearOperations: Cleared {} pending operation(s) for view [{}]",
 				clearedCount, viewId);
 		}
 	}
 
 	size_t GetQueueSize(Core::PrismaViewId viewId) {
-		std::shared_ptr<PrismaView> viewData = nullptr;
-		{
-			std::shared_lock lock(viewsMutex);
-			auto it = views.find(viewId);
-			if (it != views.end()) {
-				viewData = it->second;
-			}
-		}
+		std::shared_ptr<PrismaView> viewData = FindView(viewId);
 
 		if (!viewData) {
 			return 0;
@@ -181,21 +170,4 @@ namespace PrismaUI::ViewOperationQueue {
 		std::lock_guard lock(viewData->operationMutex);
 		return viewData->pendingOperations.size();
 	}
-
-	bool IsProcessing(Core::PrismaViewId viewId) {
-		std::shared_ptr<PrismaView> viewData = nullptr;
-		{
-			std::shared_lock lock(viewsMutex);
-			auto it = views.find(viewId);
-			if (it != views.end()) {
-				viewData = it->second;
-			}
-		}
-
-		if (!viewData) {
-			return false;
-		}
-
-		return viewData->isProcessingOperation.load(std::memory_order_acquire);
-	}
 }
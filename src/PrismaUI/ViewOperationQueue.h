@@ -1,30 +1,83 @@
-#pragma once
+﻿#pragma once
 
-#include <functional>
-#include <queue>
-#include <mutex>
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <atomic>
 
 namespace PrismaUI::Core {
 	typedef uint64_t PrismaViewId;
 	struct PrismaView;
+	struct ViewSnapshot;
 }
 
 namespace PrismaUI::ViewOperationQueue {
-	using OperationFunc = std::function<void()>;
-	
 	constexpr size_t MAX_OPERATIONS_PER_VIEW = 100;
 
-	bool EnqueueOperation(Core::PrismaViewId viewId, OperationFunc operation);
-    
-	void ProcessNextOperation(Core::PrismaViewId viewId);
+	enum class OperationType : uint8_t {
+		Show,
+		Hide,
+		Focus,
+		Unfocus,
+		Hibernate
+	};
 
-	void ProcessAllViewOperations();
+	// Typed operation record, executed by ViewManager::ApplyOperation on the UI thread.
+	struct Operation {
+		OperationType type = OperationType::Show;
+		// Focus: pause the game. Unfocus: close the FocusMenu (false when focus moves to another view).
+		bool flag = false;
+	};
+
+	// Fixed-capacity FIFO stored inline in PrismaView, guarded by PrismaView::operationMutex.
+	class OperationRing {
+	public:
+		bool push(const Operation& operation) {
+			if (count_ == MAX_OPERATIONS_PER_VIEW) return false;
+			ops_[(head_ + count_) % MAX_OPERATIONS_PER_VIEW] = operation;
+			count_++;
+			return true;
+		}
+
+		bool pop(Operation& operation) {
+			if (count_ == 0) return false;
+			operation = ops_[head_];
+			head_ = (head_ + 1) % MAX_OPERATIONS_PER_VIEW;
+			count_--;
+			return true;
+		}
+
+		const Operation& back() const {
+			return ops_[(head_ + count_ - 1) % MAX_OPERATIONS_PER_VIEW];
+		}
+
+		void pop_back() {
+			if (count_ > 0) count_--;
+		}
+
+		void clear() {
+			head_ = 0;
+			count_ = 0;
+		}
+
+		size_t size() const { return count_; }
+		bool empty() const { return count_ == 0; }
+
+	private:
+		std::array<Operation, MAX_OPERATIONS_PER_VIEW> ops_{};
+		uint32_t head_ = 0;
+		uint32_t count_ = 0;
+	};
+
+	// Folds the operation into the view's queued ones (see ViewOperationReducer), so toggling
+	// visibility or hibernating repeatedly keeps the queue short.
+	bool EnqueueOperation(Core::PrismaViewId viewId, Operation operation);
+
+	// Called once per frame on the render thread. Submits a single UI-thread task that executes
+	// every queued operation of every view, in order per view.
+	void ProcessAllViewOperations(const Core::ViewSnapshot& snapshot);
 
 	void ClearOperations(Core::PrismaViewId viewId);
 
 	size_t GetQueueSize(Core::PrismaViewId viewId);
-
-	bool IsProcessing(Core::PrismaViewId viewId);
 }
@@ -0,0 +1,206 @@
+﻿#pragma once
+
+#include "ViewOperationQueue.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Folds a view's queued Show/Hide operations into the shortest sequence with the same effect.
+//
+// All queued operations of a view run back to back in one UI-thread task before the next render
+// (see ViewOperationQueue::ProcessAllViewOperations), so intermediate states are never seen and
+// only the final state matters. That state is one of seven (a view that has no Ultralight view yet
+// only tracks visibility), so any run of operations is a function from seven states to seven states.
+// The shortest operation sequence for every reachable function is found once, on first use;
+// enqueueing replaces the foldable tail of the queue with the shortest sequence for "tail, then new
+// operation". tools/ReducerCheck verifies the table exhaustively.
+//
+// Focus, Unfocus and Hibernate are never folded and act as barriers: focusing a view unfocuses
+// whichever view had focus, unfocusing can close the FocusMenu, and hibernating fires the page's
+// prismaui:hibernate event. None of that is visible in the view's own final state.
+namespace PrismaUI::ViewOperationReducer {
+	using ViewOperationQueue::Operation;
+	using ViewOperationQueue::OperationType;
+
+	enum class State : uint8_t {
+		Visible,
+		Focused,
+		FocusedPaused,
+		Hidden,
+		Hibernated,
+		// Not created yet: the operations above only change isHidden.
+		UncreatedVisible,
+		UncreatedHidden,
+		Count
+	};
+
+	// Foldable operations first, then the barriers. Barriers are modelled so their effect on the
+	// view's own state can be checked, but a queue is never folded across one.
+	enum class Symbol : uint8_t {
+		Show,
+		Hide,
+		Count,
+		Hibernate = Count,
+		Focus,
+		FocusAndPause,
+		Unfocus,
+		UnfocusKeepMenu,
+		End
+	};
+
+	constexpr size_t STATE_COUNT = static_cast<size_t>(State::Count);
+	constexpr size_t SYMBOL_COUNT = static_cast<size_t>(Symbol::Count);
+	// Upper bound on the length of a folded sequence, checked by tools/ReducerCheck.
+	constexpr size_t MAX_FOLDED_LENGTH = 2;
+
+	constexpr bool IsBarrier(Symbol symbol) {
+		return symbol >= Symbol::Count;
+	}
+
+	constexpr Symbol ToSymbol(const Operation& operation) {
+		switch (operation.type) {
+		case OperationType::Show: return Symbol::Show;
+		case OperationType::Hide: return Symbol::Hide;
+		case OperationType::Focus: return operation.flag ? Symbol::FocusAndPause : Symbol::Focus;
+		case OperationType::Unfocus: return operation.flag ? Symbol::Unfocus : Symbol::UnfocusKeepMenu;
+		case OperationType::Hibernate: return Symbol::Hibernate;
+		}
+		return Symbol::UnfocusKeepMenu;
+	}
+
+	constexpr Operation ToOperation(Symbol symbol) {
+		switch (symbol) {
+		case Symbol::Show: return { OperationType::Show, false };
+		case Symbol::Hide: return { OperationType::Hide, false };
+		case Symbol::Hibernate: return { OperationType::Hibernate, false };
+		case Symbol::Focus: return { OperationType::Focus, false };
+		case Symbol::FocusAndPause: return { OperationType::Focus, true };
+		case Symbol::Unfocus: return { OperationType::Unfocus, true };
+		default: return { OperationType::Unfocus, false };
+		}
+	}
+
+	// Mirrors ViewManager::ApplyOperation for the view's own state.
+	constexpr State Apply(State state, Symbol symbol) {
+		if (state == State::UncreatedVisible || state == State::UncreatedHidden) {
+			// Focus, Unfocus and Hibernate return early without an Ultralight view.
+			switch (symbol) {
+			case Symbol::Show: return State::UncreatedVisible;
+			case Symbol::Hide: return State::UncreatedHidden;
+			default: return state;
+			}
+		}
+
+		const bool hidden = state == State::Hidden || state == State::Hibernated;
+		switch (symbol) {
+		case Symbol::Show:
+			return hidden ? State::Visible : state;
+		case Symbol::Hide:
+			return hidden ? state : State::Hidden;
+		case Symbol::Hibernate:
+			return State::Hibernated;
+		case Symbol::Focus:
+			return state == State::Visible ? State::Focused : state;
+		case Symbol::FocusAndPause:
+			return state == State::Visible ? State::FocusedPaused : state;
+		case Symbol::Unfocus:
+		case Symbol::UnfocusKeepMenu:
+			return hidden ? state : State::Visible;
+		default:
+			return state;
+		}
+	}
+
+	using Function = std::array<State, STATE_COUNT>;
+
+	constexpr Function Identity() {
+		Function f{};
+		for (size_t s = 0; s < STATE_COUNT; ++s) {
+			f[s] = static_cast<State>(s);
+		}
+		return f;
+	}
+
+	constexpr Function Then(const Function& f, Symbol symbol) {
+		Function result{};
+		for (size_t s = 0; s < STATE_COUNT; ++s) {
+			result[s] = Apply(f[s], symbol);
+		}
+		return result;
+	}
+
+	struct FoldedSequence {
+		Function function{};
+		uint8_t length = 0;
+		std::array<Symbol, MAX_FOLDED_LENGTH> symbols{};
+	};
+
+	// Only a handful of functions are reachable with the foldable symbols, so they are kept in a list.
+	struct FoldTable {
+		std::vector<FoldedSequence> sequences;
+		size_t longest = 0;
+		bool overflowed = false;
+
+		const FoldedSequence* Find(const Function& f) const {
+			for (const auto& sequence : sequences) {
+				if (sequence.function == f) return &sequence;
+			}
+			return nullptr;
+		}
+	};
+
+	// Breadth-first search from the empty sequence, so the first sequence found for a function is a shortest one.
+	inline FoldTable BuildFoldTable() {
+		FoldTable table;
+		table.sequences.push_back({ Identity(), 0, {} });
+
+		for (size_t head = 0; head < table.sequences.size(); ++head) {
+			for (size_t x = 0; x < SYMBOL_COUNT; ++x) {
+				const FoldedSequence current = table.sequences[head];
+				Function next = Then(current.function, static_cast<Symbol>(x));
+				if (table.Find(next)) continue;
+
+				if (current.length + 1u > MAX_FOLDED_LENGTH) {
+					table.overflowed = true;
+					continue;
+				}
+				FoldedSequence entry{ next, static_cast<uint8_t>(current.length + 1), current.symbols };
+				entry.symbols[current.length] = static_cast<Symbol>(x);
+				if (entry.length > table.longest) table.longest = entry.length;
+				table.sequences.push_back(entry);
+			}
+		}
+		return table;
+	}
+
+	inline const FoldTable& GetFoldTable() {
+		static const FoldTable table = BuildFoldTable();
+		return table;
+	}
+
+	constexpr Function Evaluate(const Symbol* symbols, size_t length) {
+		Function f = Identity();
+		for (size_t i = 0; i < length; ++i) {
+			f = Then(f, symbols[i]);
+		}
+		return f;
+	}
+
+	// Writes the shortest sequence equivalent to tail followed by symbol into out, returns its length.
+	// Neither tail nor symbol may be a barrier; out must hold MAX_FOLDED_LENGTH + 1 symbols.
+	inline size_t Fold(const Symbol* tail, size_t tailLength, Symbol symbol, Symbol* out) {
+		const FoldedSequence* folded = GetFoldTable().Find(Then(Evaluate(tail, tailLength), symbol));
+		if (!folded) {
+			// Not reachable when MAX_FOLDED_LENGTH is large enough; keep the operations unfolded.
+			for (size_t i = 0; i < tailLength; ++i) out[i] = tail[i];
+			out[tailLength] = symbol;
+			return tailLength + 1;
+		}
+		for (size_t i = 0; i < folded->length; ++i) {
+			out[i] = folded->symbols[i];
+		}
+		return folded->length;
+	}
+}
@@ -1,6 +1,9 @@
 ﻿#include "ViewRenderer.h"
 #include "Core.h"
 #include "InputHandler.h"
+#include "Settings.h"
+
+#include <Utils/ResourcePool.h>
 
 namespace PrismaUI::ViewRenderer {
 	using namespace Core;
@@ -10,40 +13,145 @@ namespace PrismaUI::ViewRenderer {
 		}
 	}
 
-	void RenderViews() {
+	struct LockedFrame {
+		std::shared_ptr<Core::PrismaView> viewData;
+		BitmapSurface* surface = nullptr;
+		RefPtr<Bitmap> bitmap;
+		void* pixels = nullptr;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		uint32_t stride = 0;
+	};
+
+	// Surface of a visible, loaded view whose frame has to be copied, nullptr otherwise.
+	// Evicted views have no pixel buffer or texture left, so their current frame is copied even if nothing is dirty.
+	static BitmapSurface* GetDirtySurface(const Core::PrismaView* viewData) {
+		if (viewData->isHidden || !viewData->ultralightView || !viewData->isLoadingFinished) return nullptr;
+
+		BitmapSurface* surface = static_cast<BitmapSurface*>(viewData->ultralightView->surface());
+		if (!surface || (surface->dirty_bounds().IsEmpty() && !viewData->resourcesEvicted)) return nullptr;
+		return surface;
+	}
+
+	// Locks the bitmaps of all visible dirty views on the UI thread, copies them on the worker pool
+	// and unlocks them again on the UI thread once every copy has completed.
+	static void RenderViewsParallel(const std::vector<std::shared_ptr<Core::PrismaView>>& viewsToRender) {
+		std::vector<LockedFrame> frames;
+		frames.reserve(viewsToRender.size());
+
+		for (const auto& viewData : viewsToRender) {
+			BitmapSurface* surface = GetDirtySurface(viewData.get());
+			if (!surface) continue;
+
+			RefPtr<Bitmap> bitmap = surface->bitmap();
+			if (!bitmap) continue;
+
+			void* pixels = bitmap->LockPixels();
+			if (!pixels) { logger::error("View [{}]: Failed to lock bitmap pixels.", viewData->id); continue; }
+
+			LockedFrame frame;
+			frame.viewData = viewData;
+			frame.surface = surface;
+			frame.bitmap = bitmap;
+			frame.pixels = pixels;
+			frame.width = bitmap->width();
+			frame.height = bitmap->height();
+			frame.stride = bitmap->row_bytes();
+			frames.push_back(std::move(frame));
+		}
+
+		if (frames.empty()) return;
+
+		std::vector<std::future<bool>> copies;
+		copies.reserve(frames.size());
+		for (const auto& frame : frames) {
+			try {
+				copies.push_back(frameCopyWorkers->submit([&frame]() {
+					return CopyLockedPixelsToBuffer(frame.viewData.get(), frame.pixels, frame.width, frame.height, frame.stride);
+				}));
+			}
+			catch (const std::exception& e) {
+				logger::error("View [{}]: Failed to schedule frame copy: {}", frame.viewData->id, e.what());
+				std::promise<bool> fallback;
+				fallback.set_value(CopyLockedPixelsToBuffer(frame.viewData.get(), frame.pixels, frame.width, frame.height, frame.stride));
+				copies.push_back(fallback.get_future());
+			}
+		}
+
+		// Every copy must finish before any bitmap is unlocked, the workers reference the locked pixels.
+		for (size_t i = 0; i < frames.size(); ++i) {
+			bool success = false;
+			try {
+				success = copies[i].get();
+			}
+			catch (const std::exception& e) {
+				logger::error("View [{}]: Exception during parallel frame copy: {}", frames[i].viewData->id, e.what());
+			}
+
+			frames[i].bitmap->UnlockPixels();
+			frames[i].surface->ClearDirtyBounds();
+			frames[i].viewData->newFrameReady = success;
+			frames[i].viewData->resourcesEvicted = false;
+		}
+	}
+
+	// Paints every view except hibernated ones, which keep their last surface untouched.
+	void RenderActiveViews(const Core::ViewSnapshot& snapshot) {
 		if (!renderer) return;
 
-		std::vector<std::shared_ptr<Core::PrismaView>> viewsToRender;
-		{
-			std::shared_lock lock(viewsMutex);
-			viewsToRender.reserve(views.size());
-			for (const auto& pair : views) {
-				if (pair.second && !pair.second->isHidden) {
-					viewsToRender.push_back(pair.second);
-				}
+		// UI thread only, reused so the list is not reallocated every frame.
+		static std::vector<View*> activeViews;
+		activeViews.clear();
+		bool anyHibernated = false;
+
+		for (const auto& viewData : snapshot.views) {
+			if (!viewData->ultralightView) continue;
+			if (viewData->isHibernated) {
+				anyHibernated = true;
+				continue;
 			}
+			activeViews.push_back(viewData->ultralightView.get());
 		}
 
-		for (const auto& viewData : viewsToRender) {
-			RenderSingleView(viewData);
+		if (!anyHibernated) {
+			renderer->Render();
+		}
+		else if (!activeViews.empty()) {
+			renderer->RenderOnly(activeViews.data(), activeViews.size());
 		}
 	}
 
-	void RenderSingleView(std::shared_ptr<Core::PrismaView> viewData) {
-		if (!viewData || !viewData->ultralightView) return;
+	void RenderViews(const Core::ViewSnapshot& snapshot) {
+		if (!renderer) return;
 
-		Surface* surface_base = viewData->ultralightView->surface();
-		if (!surface_base) return;
+		size_t dirtyCount = std::count_if(snapshot.views.begin(), snapshot.views.end(), [](const std::shared_ptr<Core::PrismaView>& viewData) {
+			return GetDirtySurface(viewData.get()) != nullptr;
+		});
 
-		BitmapSurface* surface = static_cast<BitmapSurface*>(surface_base);
+		if (frameCopyWorkers && frameCopyWorkers->size() > 1 && dirtyCount >= MIN_VIEWS_FOR_PARALLEL_COPY) {
+			RenderViewsParallel(snapshot.views);
+			return;
+		}
 
-		if (viewData->isLoadingFinished && !surface->dirty_bounds().IsEmpty()) {
-			CopyBitmapToBuffer(viewData);
-			surface->ClearDirtyBounds();
+		for (const auto& viewData : snapshot.views) {
+			if (!viewData->isHidden) {
+				RenderSingleView(viewData);
+			}
 		}
 	}
 
-	void CopyBitmapToBuffer(std::shared_ptr<Core::PrismaView> viewData) {
+	void RenderSingleView(const std::shared_ptr<Core::PrismaView>& viewData) {
+		if (!viewData) return;
+
+		BitmapSurface* surface = GetDirtySurface(viewData.get());
+		if (!surface) return;
+
+		CopyBitmapToBuffer(viewData);
+		surface->ClearDirtyBounds();
+		viewData->resourcesEvicted = false;
+	}
+
+	void CopyBitmapToBuffer(const std::shared_ptr<Core::PrismaView>& viewData) {
 		if (!viewData || !viewData->ultralightView) return;
 		BitmapSurface* surface = static_cast<BitmapSurface*>(viewData->ultralightView->surface());
 		if (!surface) return;
@@ -53,44 +161,153 @@ namespace PrismaUI::ViewRenderer {
 		void* pixels = bitmap->LockPixels();
 		if (!pixels) { logger::error("View [{}]: Failed to lock bitmap pixels.", viewData->id); return; }
 
-		uint32_t width = bitmap->width();
-		uint32_t height = bitmap->height();
-		uint32_t stride = bitmap->row_bytes();
-		size_t required_size = static_cast<size_t>(height) * stride;
-		if (width == 0 || height == 0 || required_size == 0) {
-			bitmap->UnlockPixels(); return;
-		}
-
-		bool success = false;
-		{
-			std::lock_guard lock(viewData->bufferMutex);
-			try {
-				if (viewData->pixelBuffer.size() != required_size) { viewData->pixelBuffer.resize(required_size); }
-				memcpy(viewData->pixelBuffer.data(), pixels, required_size);
-				viewData->bufferWidth = width; viewData->bufferHeight = height; viewData->bufferStride = stride;
-				success = true;
-			}
-			catch (const std::exception& e) {
-				logger::error("View [{}]: Exception during pixel buffer copy/resize: {}", viewData->id, e.what());
-				viewData->pixelBuffer.clear(); viewData->pixelBuffer.shrink_to_fit();
-				viewData->bufferWidth = viewData->bufferHeight = viewData->bufferStride = 0;
-			}
-		}
+		bool success = CopyLockedPixelsToBuffer(viewData.get(), pixels, bitmap->width(), bitmap->height(), bitmap->row_bytes());
 
 		bitmap->UnlockPixels();
 		if (success) viewData->newFrameReady = true;
 		else viewData->newFrameReady = false;
 	}
 
+	bool CopyLockedPixelsToBuffer(Core::PrismaView* viewData, const void* pixels, uint32_t width, uint32_t height, uint32_t stride) {
+		if (!viewData || !pixels) return false;
+
+		size_t required_size = static_cast<size_t>(height) * stride;
+		if (width == 0 || height == 0 || required_size == 0) return false;
+
+		std::lock_guard lock(viewData->bufferMutex);
+		if (!viewData->pixelBuffer.resize_discard(required_size)) {
+			logger::error("View [{}]: Failed to allocate a {} byte pixel buffer.", viewData->id, required_size);
+			viewData->pixelBuffer.release();
+			viewData->bufferWidth = viewData->bufferHeight = viewData->bufferStride = 0;
+			return false;
+		}
+		memcpy(viewData->pixelBuffer.data(), pixels, required_size);
+		viewData->bufferWidth = width; viewData->bufferHeight = height; viewData->bufferStride = stride;
+		return true;
+	}
+
+	struct TextureKey {
+		uint32_t width;
+		uint32_t height;
+		DXGI_FORMAT format;
+
+		auto operator<=>(const TextureKey&) const = default;
+	};
+
+	struct PooledTexture {
+		ID3D11Texture2D* texture = nullptr;
+		ID3D11ShaderResourceView* textureView = nullptr;
+	};
+
+	constexpr DXGI_FORMAT VIEW_TEXTURE_FORMAT = DXGI_FORMAT_B8G8R8A8_UNORM;
+
+	// Textures are created and released on the render thread, except when a view's last reference goes away elsewhere.
+	struct TexturePool {
+		std::mutex mutex;
+		ResourcePool<TextureKey, PooledTexture> textures{ Settings::RendererSettings{}.texturePoolBytes, [](PooledTexture& pooled) {
+			if (pooled.textureView) pooled.textureView->Release();
+			if (pooled.texture) pooled.texture->Release();
+			} };
+		std::once_flag configured;
+	};
+
+	// Never destroyed: ~PrismaView can release a slot texture during static destruction at exit, and the
+	// pooled D3D objects must not be released from a static destructor. Shutdown trims it explicitly.
+	static TexturePool& GetTexturePool() {
+		static auto& texturePool = *new TexturePool;
+		std::call_once(texturePool.configured, []() {
+			texturePool.textures.set_capacity(Settings::Get().renderer.texturePoolBytes);
+			});
+		return texturePool;
+	}
+
+	static uint64_t TextureBytes(uint32_t width, uint32_t height) {
+		return static_cast<uint64_t>(width) * height * 4;
+	}
+
 	void ReleaseViewTexture(Core::PrismaView* viewData) {
 		if (!viewData) return;
+		ReleaseSlotTexture(viewData->slot);
+	}
+
+	void ReleaseSlotTexture(Core::ViewSlot slot) {
+		if (slot >= MAX_VIEW_SLOTS) return;
+
+		PooledTexture pooled{ frameTable.texture[slot], frameTable.textureView[slot] };
+		const uint32_t width = frameTable.textureWidth[slot];
+		const uint32_t height = frameTable.textureHeight[slot];
+		frameTable.texture[slot] = nullptr;
+		frameTable.textureView[slot] = nullptr;
+		frameTable.textureWidth[slot] = 0; frameTable.textureHeight[slot] = 0;
+
+		if (pooled.texture && pooled.textureView && width != 0 && height != 0) {
+			TexturePool& texturePool = GetTexturePool();
+			std::lock_guard lock(texturePool.mutex);
+			texturePool.textures.release({ width, height, VIEW_TEXTURE_FORMAT }, pooled, TextureBytes(width, height));
+			return;
+		}
 
-		if (viewData->textureView) { viewData->textureView->Release(); viewData->textureView = nullptr; }
-		if (viewData->texture) { viewData->texture->Release(); viewData->texture = nullptr; }
-		viewData->textureWidth = 0; viewData->textureHeight = 0;
+		if (pooled.textureView) pooled.textureView->Release();
+		if (pooled.texture) pooled.texture->Release();
 	}
 
-	void UpdateSingleTextureFromBuffer(std::shared_ptr<Core::PrismaView> viewData) {
+	void TrimTexturePool(uint64_t maxBytes) {
+		TexturePool& texturePool = GetTexturePool();
+		std::lock_guard lock(texturePool.mutex);
+		texturePool.textures.trim(maxBytes);
+	}
+
+	TexturePoolStats GetTexturePoolStats() {
+		TexturePool& texturePool = GetTexturePool();
+		std::lock_guard lock(texturePool.mutex);
+		auto stats = texturePool.textures.get_stats();
+		return { stats.hits, stats.misses, stats.evictions, stats.pooledBytes, stats.pooledCount };
+	}
+
+	struct DeferredRelease {
+		std::shared_ptr<Core::PrismaView> viewData;
+		std::function<void(Core::PrismaViewId)> onReleased;
+	};
+
+	static std::mutex deferredReleaseMutex;
+	static std::vector<DeferredRelease> deferredReleases;
+
+	void DeferRelease(std::shared_ptr<Core::PrismaView> viewData, std::function<void(Core::PrismaViewId)> onReleased) {
+		if (!viewData) return;
+
+		std::lock_guard lock(deferredReleaseMutex);
+		deferredReleases.push_back({ std::move(viewData), std::move(onReleased) });
+	}
+
+	void ReleaseDeferredViews() {
+		std::vector<DeferredRelease> releases;
+		{
+			std::lock_guard lock(deferredReleaseMutex);
+			if (deferredReleases.empty()) return;
+			releases.swap(deferredReleases);
+		}
+
+		for (auto& release : releases) {
+			const Core::PrismaViewId viewId = release.viewData->id;
+			ReleaseViewTexture(release.viewData.get());
+			release.viewData->pendingResourceRelease = false;
+			// Usually the last reference, which frees the view and its frame table slot.
+			release.viewData.reset();
+
+			logger::info("Destroy: View [{}] successfully destroyed", viewId);
+
+			if (release.onReleased) {
+				try {
+					release.onReleased(viewId);
+				}
+				catch (const std::exception& e) {
+					logger::error("Destroy: Exception in completion callback for View [{}]: {}", viewId, e.what());
+				}
+			}
+		}
+	}
+
+	void UpdateSingleTextureFromBuffer(const std::shared_ptr<Core::PrismaView>& viewData) {
 		if (!viewData) return;
 
 		if (viewData->pendingResourceRelease.load()) {
@@ -121,15 +338,30 @@ namespace PrismaUI::ViewRenderer {
 		if (!viewData || !d3dDevice || !d3dContext || !pixels || width == 0 || height == 0) return;
 
 		if (!viewData->texture || viewData->textureWidth != width || viewData->textureHeight != height) {
-			logger::debug("View [{}]: Creating/Recreating texture ({}x{})", viewData->id, width, height);
 			ReleaseViewTexture(viewData);
+		}
+
+		if (!viewData->texture) {
+			TexturePool& texturePool = GetTexturePool();
+			std::lock_guard lock(texturePool.mutex);
+			if (auto pooled = texturePool.textures.acquire({ width, height, VIEW_TEXTURE_FORMAT })) {
+				viewData->texture = pooled->texture;
+				viewData->textureView = pooled->textureView;
+				viewData->textureWidth = width;
+				viewData->textureHeight = height;
+				logger::debug("View [{}]: Reusing pooled texture ({}x{})", viewData->id, width, height);
+			}
+		}
+
+		if (!viewData->texture) {
+			logger::debug("View [{}]: Creating/Recreating texture ({}x{})", viewData->id, width, height);
 			D3D11_TEXTURE2D_DESC desc;
 			ZeroMemory(&desc, sizeof(desc));
 			desc.Width = width;
 			desc.Height = height;
 			desc.MipLevels = 1;
 			desc.ArraySize = 1;
-			desc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+			desc.Format = VIEW_TEXTURE_FORMAT;
 			desc.SampleDesc.Count = 1;
 			desc.Usage = D3D11_USAGE_DYNAMIC;
 			desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
@@ -220,27 +452,15 @@ namespace PrismaUI::ViewRenderer {
 		if (backupRasterizerState) backupRasterizerState->Release();
 	}
 
-	void DrawViews() {
-		if (!spriteBatch || !commonStates) return;
-
-		std::vector<std::shared_ptr<Core::PrismaView>> viewsToDraw;
-		{
-			std::shared_lock lock(viewsMutex);
-			viewsToDraw.reserve(views.size());
-			for (const auto& pair : views) {
-				if (pair.second && !pair.second->isHidden.load() &&
-					!pair.second->pendingResourceRelease.load() &&
-					pair.second->textureView) {
-					viewsToDraw.push_back(pair.second);
-				}
-			}
-		}
+	static bool ShouldDraw(Core::ViewSlot slot) {
+		return !frameTable.isHidden[slot].load() && !frameTable.pendingResourceRelease[slot].load() && frameTable.textureView[slot];
+	}
 
-		if (viewsToDraw.empty()) return;
+	void DrawViews(const Core::ViewSnapshot& snapshot) {
+		if (!spriteBatch || !commonStates) return;
 
-		std::sort(viewsToDraw.begin(), viewsToDraw.end(), [](const std::shared_ptr<Core::PrismaView>& a, const std::shared_ptr<Core::PrismaView>& b) {
-			return a->order < b->order;
-		});
+		// drawOrder is already sorted back to front, only visibility is checked per frame.
+		if (std::none_of(snapshot.drawOrder.begin(), snapshot.drawOrder.end(), ShouldDraw)) return;
 
 		try {
 			ID3D11BlendState* backupBlendState = nullptr; FLOAT backupBlendFactor[4]; UINT backupSampleMask = 0;
@@ -252,8 +472,10 @@ namespace PrismaUI::ViewRenderer {
 
 			spriteBatch->Begin(DirectX::SpriteSortMode_Deferred, commonStates->AlphaBlend());
 
-			for (const auto& viewData : viewsToDraw) {
-				DrawSingleTexture(viewData);
+			for (Core::ViewSlot slot : snapshot.drawOrder) {
+				if (ShouldDraw(slot)) {
+					DrawSingleTexture(slot);
+				}
 			}
 
 			spriteBatch->End();
@@ -274,14 +496,19 @@ namespace PrismaUI::ViewRenderer {
 		}
 	}
 
-	void DrawSingleTexture(std::shared_ptr<Core::PrismaView> viewData) {
-		if (!viewData || !viewData->textureView || viewData->textureWidth == 0 || viewData->textureHeight == 0) return;
+	void DrawSingleTexture(Core::ViewSlot slot) {
+		if (slot >= MAX_VIEW_SLOTS) return;
+
+		ID3D11ShaderResourceView* textureView = frameTable.textureView[slot];
+		uint32_t textureWidth = frameTable.textureWidth[slot];
+		uint32_t textureHeight = frameTable.textureHeight[slot];
+		if (!textureView || textureWidth == 0 || textureHeight == 0) return;
 
 		DirectX::SimpleMath::Vector2 position(0.0f, 0.0f);
-		RECT sourceRect = { 0, 0, (long)viewData->textureWidth, (long)viewData->textureHeight };
+		RECT sourceRect = { 0, 0, (long)textureWidth, (long)textureHeight };
 
 		spriteBatch->Draw(
-			viewData->textureView, position, &sourceRect,
+			textureView, position, &sourceRect,
 			DirectX::Colors::White, 0.f, DirectX::SimpleMath::Vector2::Zero,
 			1.0f, DirectX::SpriteEffects_None, 0.f
 		);
@@ -7,20 +7,48 @@
 #include <JavaScriptCore/JSRetainPtr.h>
 
 namespace PrismaUI::Core {
+	typedef uint64_t PrismaViewId;
+	typedef uint32_t ViewSlot;
 	struct PrismaView;
+	struct ViewSnapshot;
 }
 
 namespace PrismaUI::ViewRenderer {
 	using namespace ultralight;
 
+	// Frame copies only fan out to the worker pool when at least this many views are dirty.
+	constexpr size_t MIN_VIEWS_FOR_PARALLEL_COPY = 2;
+
 	void UpdateLogic();
-	void RenderViews();
-	void RenderSingleView(std::shared_ptr<Core::PrismaView> viewData);
-	void CopyBitmapToBuffer(std::shared_ptr<Core::PrismaView> viewData);
-	void DrawViews();
-	void UpdateSingleTextureFromBuffer(std::shared_ptr<Core::PrismaView> viewData);
+	void RenderActiveViews(const Core::ViewSnapshot& snapshot);
+	void RenderViews(const Core::ViewSnapshot& snapshot);
+	void RenderSingleView(const std::shared_ptr<Core::PrismaView>& viewData);
+	void CopyBitmapToBuffer(const std::shared_ptr<Core::PrismaView>& viewData);
+	bool CopyLockedPixelsToBuffer(Core::PrismaView* viewData, const void* pixels, uint32_t width, uint32_t height, uint32_t stride);
+	void DrawViews(const Core::ViewSnapshot& snapshot);
+	void UpdateSingleTextureFromBuffer(const std::shared_ptr<Core::PrismaView>& viewData);
 	void CopyPixelsToTexture(Core::PrismaView* viewData, void* pixels, uint32_t width, uint32_t height, uint32_t stride);
-	void DrawSingleTexture(std::shared_ptr<Core::PrismaView> viewData);
+	void DrawSingleTexture(Core::ViewSlot slot);
 	void DrawCursor();
 	void ReleaseViewTexture(Core::PrismaView* viewData);
+	// Returns the slot's texture to the texture pool.
+	void ReleaseSlotTexture(Core::ViewSlot slot);
+
+	struct TexturePoolStats {
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		uint64_t evictions = 0;
+		uint64_t pooledBytes = 0;
+		uint32_t pooledCount = 0;
+	};
+
+	// Frees pooled textures, least recently used first, until at most maxBytes remain.
+	void TrimTexturePool(uint64_t maxBytes);
+	TexturePoolStats GetTexturePoolStats();
+
+	// Hands a destroyed view to the render thread, which releases its textures in the next D3DPresent,
+	// drops the view and then calls onReleased.
+	void DeferRelease(std::shared_ptr<Core::PrismaView> viewData, std::function<void(Core::PrismaViewId)> onReleased);
+	// Render thread, or shutdown once the UI thread has finished.
+	void ReleaseDeferredViews();
 }
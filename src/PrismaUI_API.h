@@ -19,18 +19,21 @@ namespace PRISMA_UI_API
 
 	enum class InterfaceVersion : uint8_t
 	{
-		V1
+		V1,
+		V2
 	};
 
 	typedef void (*OnDomReadyCallback)(PrismaView view);
 	typedef void (*JSCallback)(const char* result);
 	typedef void (*JSListenerCallback)(const char* argument);
+	typedef void (*OnDestroyedCallback)(PrismaView view);
 
 	// PrismaUI modder interface v1
 	class IVPrismaUI1
 	{
 	public:
-		// Create view.
+		// Create view. At most 256 views, pre-warmed ones included, can exist at the same time across
+		// all plugins. Returns 0 when that limit is reached, destroy views you no longer need.
 		virtual PrismaView CreateView(const char* htmlPath, OnDomReadyCallback onDomReadyCallback = nullptr) noexcept = 0;
 
 		// Send JS code to UI.
@@ -69,7 +72,7 @@ namespace PRISMA_UI_API
 		// Returns true if view exists.
 		virtual bool IsValid(PrismaView view) noexcept = 0;
 
-		// Completely destroy view.
+		// Completely destroy view. Returns immediately, resources are released over the next frames.
 		virtual void Destroy(PrismaView view) noexcept = 0;
 
 		// Set view order.
@@ -79,6 +82,147 @@ namespace PRISMA_UI_API
 		virtual int GetOrder(PrismaView view) noexcept = 0;
 	};
 
+	// PrismaUI memory usage figures.
+	struct MemoryStats
+	{
+		uint64_t cpuBytes;
+		uint64_t gpuBytes;
+		uint64_t budgetBytes;
+		uint32_t viewCount;
+		uint32_t evictedViewCount;
+		uint32_t hibernatedViewCount;
+		uint32_t purgeCount;
+	};
+
+	// Memory held by a single view's frame buffers.
+	struct ViewMemoryStats
+	{
+		uint64_t cpuBytes;
+		uint64_t gpuBytes;
+		bool evicted;
+	};
+
+	// Shared view asset cache figures.
+	struct AssetCacheStats
+	{
+		uint64_t hits;
+		uint64_t misses;
+		uint64_t bytesServedFromCache;
+		uint64_t bytesReadFromDisk;
+		uint64_t cachedBytes;
+		uint64_t capacityBytes;
+		uint32_t entryCount;
+		uint32_t dedupedEntryCount;
+	};
+
+	// Counts of Ultralight's internal messages since startup. Per-category counts include errors,
+	// categories are guessed from the message text.
+	struct UltralightLogStats
+	{
+		uint64_t errors;
+		uint64_t warnings;
+		uint64_t resourceWarnings;
+		uint64_t memoryWarnings;
+		uint64_t fontWarnings;
+		uint64_t graphicsWarnings;
+		uint64_t scriptWarnings;
+		uint64_t otherWarnings;
+	};
+
+	// One priority lane of the PrismaUI UI thread.
+	struct UIQueueLaneStats
+	{
+		uint32_t depth;
+		uint32_t peakDepth;
+		uint64_t executed;
+		uint64_t promoted;
+		double maxWaitMs;
+		double averageWaitMs;
+	};
+
+	// Lanes of the UI thread, highest priority first.
+	struct UIQueueStats
+	{
+		UIQueueLaneStats input;
+		UIQueueLaneStats render;
+		UIQueueLaneStats interop;
+		UIQueueLaneStats background;
+	};
+
+	// Invoke/InteropCall scripts of one view. Scripts run once per frame within a shared time budget.
+	struct ScriptQueueStats
+	{
+		uint32_t queueDepth;
+		uint64_t executed;
+		// Scripts that had to wait for a later frame because the budget was spent.
+		uint64_t deferred;
+	};
+
+	// Arena holding the views' CPU-side frame buffers. Released buffers are cached and reused by any view.
+	struct FrameBufferArenaStats
+	{
+		uint32_t blocksInUse;
+		uint64_t bytesInUse;
+		uint32_t blocksCached;
+		uint64_t bytesCached;
+		uint64_t allocations;
+		uint64_t reuses;
+		uint64_t allocationFailures;
+		uint32_t largePageBlocks;
+		bool largePagesEnabled;
+	};
+
+	// PrismaUI modder interface v2
+	class IVPrismaUI2 : public IVPrismaUI1
+	{
+	public:
+		// Get memory used by PrismaUI views. gpuBytes includes textures kept for reuse by new views,
+		// and the budget applies to that same total.
+		virtual MemoryStats GetMemoryStats() noexcept = 0;
+
+		// Get memory used by a single view.
+		virtual ViewMemoryStats GetViewMemoryStats(PrismaView view) noexcept = 0;
+
+		// Hide a view and freeze its animations until it is shown again.
+		// The page receives a 'prismaui:hibernate' / 'prismaui:resume' event on document to pause its own timers.
+		virtual void Hibernate(PrismaView view) noexcept = 0;
+
+		// Returns true if view is hibernated.
+		virtual bool IsHibernated(PrismaView view) noexcept = 0;
+
+		// Create a hidden view that is loaded ahead of time during loading screens or idle frames,
+		// so a later Show() is instant. Returns 0 if the pre-warm budget is exhausted or the limit of
+		// 256 views is reached. Pre-warmed views count towards that limit like any other view.
+		virtual PrismaView PrewarmView(const char* htmlPath, OnDomReadyCallback onDomReadyCallback = nullptr) noexcept = 0;
+
+		// Views are created a few per frame. Call right after CreateView to have a view created
+		// before others requested in the same frame. Higher values are created first, default 0.
+		virtual void SetCreationPriority(PrismaView view, int priority) noexcept = 0;
+
+		// Get hit/miss figures of the asset cache shared by all views. All zero when the cache is disabled.
+		virtual AssetCacheStats GetAssetCacheStats() noexcept = 0;
+
+		// Create view in a named session, use your plugin name. Views sharing a session share cookies,
+		// localStorage and IndexedDB. Persistent sessions are stored on disk and survive game restarts.
+		// Subject to the same 256 view limit as CreateView.
+		virtual PrismaView CreateViewInSession(const char* htmlPath, const char* sessionName, bool persistent = true, OnDomReadyCallback onDomReadyCallback = nullptr) noexcept = 0;
+
+		// Get error and warning counts reported by the Ultralight renderer itself, per category.
+		virtual UltralightLogStats GetUltralightLogStats() noexcept = 0;
+
+		// Get queue depth and wait times of the UI thread's priority lanes.
+		virtual UIQueueStats GetUIQueueStats() noexcept = 0;
+
+		// Get the number of Invoke/InteropCall scripts waiting, run and carried over to a later frame for a view.
+		virtual ScriptQueueStats GetScriptQueueStats(PrismaView view) noexcept = 0;
+
+		// Destroy view like Destroy() and get called back once its Ultralight and GPU resources are released.
+		virtual void DestroyWithCallback(PrismaView view, OnDestroyedCallback onDestroyed) noexcept = 0;
+
+		// Get block counts and reuse figures of the frame buffer arena.
+		virtual FrameBufferArenaStats GetFrameBufferArenaStats() noexcept = 0;
+	};
+
 	typedef void* (*_RequestPluginAPI)(const InterfaceVersion interfaceVersion);
 
 	/// <summary>
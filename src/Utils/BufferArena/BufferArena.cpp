@@ -0,0 +1,226 @@
+﻿#include "BufferArena.h"
+
+#include <windows.h>
+
+#include <bit>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace BufferArena {
+	namespace detail {
+		struct Block {
+			std::byte* data;
+			bool largePage;
+		};
+
+		struct State {
+			std::mutex mutex;
+			// Cached blocks by size class, most recently released last.
+			std::map<size_t, std::vector<Block>> freeBlocks;
+			uint64_t maxCachedBytes = 128ull * 1024 * 1024;
+			size_t largePageSize = 0;
+			Stats stats;
+		};
+
+		// Never destroyed: buffers owned by objects that outlive main (views released during static
+		// destruction at exit) still return their blocks here.
+		static State& GetState() {
+			static auto& state = *new State;
+			return state;
+		}
+
+		static bool EnableLockMemoryPrivilege() {
+			HANDLE token = nullptr;
+			if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) {
+				return false;
+			}
+
+			TOKEN_PRIVILEGES privileges{};
+			privileges.PrivilegeCount = 1;
+			privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+
+			// AdjustTokenPrivileges succeeds without granting anything when the account lacks the privilege.
+			bool enabled = LookupPrivilegeValueW(nullptr, L"SeLockMemoryPrivilege", &privileges.Privileges[0].Luid) &&
+				AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr) &&
+				GetLastError() == ERROR_SUCCESS;
+
+			CloseHandle(token);
+			return enabled;
+		}
+
+		static Block AllocateBlock(size_t bytes, size_t largePageSize) {
+			if (largePageSize != 0 && bytes % largePageSize == 0) {
+				void* data = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+				if (data) return { static_cast<std::byte*>(data), true };
+			}
+			return { static_cast<std::byte*>(VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE)), false };
+		}
+
+		static void FreeBlock(const Block& block) {
+			VirtualFree(block.data, 0, MEM_RELEASE);
+		}
+
+		// state.mutex must be held.
+		static void TrimLocked(State& state, uint64_t maxBytes) {
+			auto& freeBlocks = state.freeBlocks;
+			auto& stats = state.stats;
+			for (auto it = freeBlocks.rbegin(); it != freeBlocks.rend() && stats.bytesCached > maxBytes; ++it) {
+				auto& blocks = it->second;
+				while (!blocks.empty() && stats.bytesCached > maxBytes) {
+					if (blocks.front().largePage) stats.largePageBlocks--;
+					FreeBlock(blocks.front());
+					blocks.erase(blocks.begin());
+					stats.blocksCached--;
+					stats.bytesCached -= it->first;
+				}
+			}
+			std::erase_if(freeBlocks, [](const auto& pair) { return pair.second.empty(); });
+		}
+
+		static Block Acquire(size_t classBytes) {
+			State& state = GetState();
+			std::lock_guard lock(state.mutex);
+			auto& stats = state.stats;
+
+			auto it = state.freeBlocks.find(classBytes);
+			if (it != state.freeBlocks.end() && !it->second.empty()) {
+				Block block = it->second.back();
+				it->second.pop_back();
+				stats.blocksCached--;
+				stats.bytesCached -= classBytes;
+				stats.blocksInUse++;
+				stats.bytesInUse += classBytes;
+				stats.reuses++;
+				return block;
+			}
+
+			Block block = AllocateBlock(classBytes, state.largePageSize);
+			if (!block.data) {
+				// Cached blocks of other classes may be what stands in the way.
+				TrimLocked(state, 0);
+				block = AllocateBlock(classBytes, state.largePageSize);
+			}
+			if (!block.data) {
+				stats.allocationFailures++;
+				return block;
+			}
+
+			if (block.largePage) stats.largePageBlocks++;
+			stats.blocksInUse++;
+			stats.bytesInUse += classBytes;
+			stats.allocations++;
+			return block;
+		}
+
+		static void Release(const Block& block, size_t classBytes) {
+			State& state = GetState();
+			std::lock_guard lock(state.mutex);
+			auto& stats = state.stats;
+			stats.blocksInUse--;
+			stats.bytesInUse -= classBytes;
+
+			if (stats.bytesCached + classBytes > state.maxCachedBytes) {
+				if (block.largePage) stats.largePageBlocks--;
+				FreeBlock(block);
+				return;
+			}
+
+			state.freeBlocks[classBytes].push_back(block);
+			stats.blocksCached++;
+			stats.bytesCached += classBytes;
+		}
+	}
+
+	bool Configure(uint64_t maxCachedBytes, bool useLargePages) {
+		detail::State& state = detail::GetState();
+		std::lock_guard lock(state.mutex);
+		state.maxCachedBytes = maxCachedBytes;
+		detail::TrimLocked(state, maxCachedBytes);
+
+		state.largePageSize = 0;
+		if (useLargePages && detail::EnableLockMemoryPrivilege()) {
+			state.largePageSize = GetLargePageMinimum();
+		}
+		state.stats.largePagesEnabled = state.largePageSize != 0;
+		return state.stats.largePagesEnabled;
+	}
+
+	void Trim(uint64_t maxCachedBytes) {
+		detail::State& state = detail::GetState();
+		std::lock_guard lock(state.mutex);
+		detail::TrimLocked(state, maxCachedBytes);
+	}
+
+	Stats GetStats() {
+		detail::State& state = detail::GetState();
+		std::lock_guard lock(state.mutex);
+		return state.stats;
+	}
+
+	size_t SizeClass(size_t bytes) {
+		if (bytes <= MIN_BLOCK_BYTES) return MIN_BLOCK_BYTES;
+
+		// Four classes per power of two.
+		size_t step = std::bit_floor(bytes) / 4;
+		size_t classBytes = (bytes + step - 1) / step * step;
+
+		// Large-page sized classes can be backed by large pages when they are enabled.
+		constexpr size_t LARGE_PAGE_BYTES = 2 * 1024 * 1024;
+		size_t granularity = classBytes >= LARGE_PAGE_BYTES ? LARGE_PAGE_BYTES : MIN_BLOCK_BYTES;
+		return (classBytes + granularity - 1) / granularity * granularity;
+	}
+
+	Buffer::Buffer(Buffer&& other) noexcept :
+		data_(std::exchange(other.data_, nullptr)),
+		size_(std::exchange(other.size_, 0)),
+		capacity_(std::exchange(other.capacity_, 0)),
+		largePage_(std::exchange(other.largePage_, false)) {
+	}
+
+	Buffer& Buffer::operator=(Buffer&& other) noexcept {
+		if (this != &other) {
+			release();
+			data_ = std::exchange(other.data_, nullptr);
+			size_ = std::exchange(other.size_, 0);
+			capacity_ = std::exchange(other.capacity_, 0);
+			largePage_ = std::exchange(other.largePage_, false);
+		}
+		return *this;
+	}
+
+	bool Buffer::resize_discard(size_t size) {
+		if (size == 0) {
+			release();
+			return true;
+		}
+
+		if (data_ && size <= capacity_ && size > capacity_ / 2) {
+			size_ = size;
+			return true;
+		}
+
+		release();
+
+		size_t classBytes = SizeClass(size);
+		detail::Block block = detail::Acquire(classBytes);
+		if (!block.data) return false;
+
+		data_ = block.data;
+		size_ = size;
+		capacity_ = classBytes;
+		largePage_ = block.largePage;
+		return true;
+	}
+
+	void Buffer::release() {
+		if (!data_) return;
+
+		detail::Release({ data_, largePage_ }, capacity_);
+		data_ = nullptr;
+		size_ = 0;
+		capacity_ = 0;
+		largePage_ = false;
+	}
+}
@@ -0,0 +1,68 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Page-backed memory for large, long-lived byte buffers such as view frames.
+//
+// Blocks come straight from VirtualAlloc, rounded up to a size class (four per power of two, so at
+// most a quarter is wasted). Released blocks are cached per class and handed to the next buffer of
+// that class, from any view, instead of going back to the system. Frames of the same resolution
+// therefore keep reusing the same few blocks rather than fragmenting the heap.
+namespace BufferArena {
+	// Smallest block, also the allocation granularity of VirtualAlloc.
+	constexpr size_t MIN_BLOCK_BYTES = 64 * 1024;
+
+	struct Stats {
+		// Blocks handed out right now and their total size.
+		uint32_t blocksInUse = 0;
+		uint64_t bytesInUse = 0;
+		// Released blocks waiting for reuse.
+		uint32_t blocksCached = 0;
+		uint64_t bytesCached = 0;
+		uint64_t allocations = 0;
+		uint64_t reuses = 0;
+		uint64_t allocationFailures = 0;
+		// Blocks in use or cached that are backed by large pages.
+		uint32_t largePageBlocks = 0;
+		bool largePagesEnabled = false;
+	};
+
+	// maxCachedBytes caps the cache, blocks released beyond it are freed at once.
+	// Large pages need the "Lock pages in memory" privilege; returns whether they are in use.
+	bool Configure(uint64_t maxCachedBytes, bool useLargePages);
+	// Frees cached blocks, largest first, until at most maxCachedBytes remain.
+	void Trim(uint64_t maxCachedBytes);
+	Stats GetStats();
+	size_t SizeClass(size_t bytes);
+
+	// Move-only owner of one block. Thread-safe as long as each Buffer is used by one thread at a time.
+	class Buffer {
+	public:
+		Buffer() = default;
+		~Buffer() { release(); }
+
+		Buffer(const Buffer&) = delete;
+		Buffer& operator=(const Buffer&) = delete;
+		Buffer(Buffer&& other) noexcept;
+		Buffer& operator=(Buffer&& other) noexcept;
+
+		std::byte* data() const { return data_; }
+		size_t size() const { return size_; }
+		// Size of the underlying block.
+		size_t capacity() const { return capacity_; }
+		bool empty() const { return size_ == 0; }
+
+		// Sets the size. Contents are discarded whenever a different block is needed, which happens
+		// when the buffer grows past its block or shrinks below half of it. False if allocation failed.
+		bool resize_discard(size_t size);
+		// Returns the block to the arena.
+		void release();
+
+	private:
+		std::byte* data_ = nullptr;
+		size_t size_ = 0;
+		size_t capacity_ = 0;
+		bool largePage_ = false;
+	};
+}
@@ -0,0 +1,245 @@
+﻿#include "DeferredLog.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace DeferredLog {
+	namespace detail {
+		// Single-producer (owning thread) / single-consumer (formatter thread) byte ring.
+		struct ThreadRing {
+			alignas(64) std::atomic<size_t> head = 0;
+			alignas(64) std::atomic<size_t> tail = 0;
+			alignas(64) std::byte data[RING_BUFFER_BYTES];
+		};
+
+		// Marks the unused end of the ring when a record wraps around.
+		constexpr uint32_t PADDING_RECORD = 0xFFFFFFFF;
+		constexpr size_t RECORD_ALIGNMENT = alignof(RecordHeader);
+
+		static std::mutex ringsMutex;
+		static std::vector<std::shared_ptr<ThreadRing>> rings;
+
+		static std::mutex stateMutex;
+		static std::condition_variable wakeFormatter;
+		static std::condition_variable flushed;
+		static Sink sink = nullptr;
+		static bool running = false;
+		static bool stopRequested = false;
+		static uint64_t flushGeneration = 0;
+		static uint64_t completedGeneration = 0;
+
+		static std::atomic<bool> drainRequested = false;
+
+		static std::atomic<uint64_t> writtenCount = 0;
+		static std::atomic<uint64_t> droppedCount = 0;
+		static std::atomic<uint64_t> oversizedCount = 0;
+
+		static ThreadRing& GetThreadRing() {
+			thread_local std::shared_ptr<ThreadRing> ring = [] {
+				auto created = std::make_shared<ThreadRing>();
+				std::lock_guard lock(ringsMutex);
+				rings.push_back(created);
+				return created;
+			}();
+			return *ring;
+		}
+
+		std::byte* Reserve(size_t size) {
+			size = (size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+
+			ThreadRing& ring = GetThreadRing();
+			size_t head = ring.head.load(std::memory_order_relaxed);
+			size_t tail = ring.tail.load(std::memory_order_acquire);
+			size_t offset = head % RING_BUFFER_BYTES;
+			size_t untilEnd = RING_BUFFER_BYTES - offset;
+
+			// Records are contiguous, so a record that would straddle the end skips to the start.
+			size_t needed = size <= untilEnd ? size : untilEnd + size;
+			if (RING_BUFFER_BYTES - (head - tail) < needed) {
+				droppedCount.fetch_add(1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			if (size > untilEnd) {
+				std::memcpy(ring.data + offset, &PADDING_RECORD, sizeof(PADDING_RECORD));
+				ring.head.store(head + untilEnd, std::memory_order_release);
+				offset = 0;
+			}
+			return ring.data + offset;
+		}
+
+		void Commit(std::byte* record) {
+			ThreadRing& ring = GetThreadRing();
+			uint32_t size;
+			std::memcpy(&size, record, sizeof(size));
+			size = static_cast<uint32_t>((size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1));
+
+			size_t head = ring.head.load(std::memory_order_relaxed) + size;
+			ring.head.store(head, std::memory_order_release);
+			writtenCount.fetch_add(1, std::memory_order_relaxed);
+
+			// Wake the formatter early instead of waiting out FLUSH_INTERVAL once a ring is half full.
+			if (head - ring.tail.load(std::memory_order_relaxed) > RING_BUFFER_BYTES / 2 &&
+				!drainRequested.exchange(true, std::memory_order_relaxed)) {
+				wakeFormatter.notify_one();
+			}
+		}
+
+		void WriteDirect(Level level, std::string_view message) {
+			oversizedCount.fetch_add(1, std::memory_order_relaxed);
+			Sink target;
+			{
+				std::lock_guard lock(stateMutex);
+				target = sink;
+			}
+			if (target) {
+				target(level, message);
+			}
+		}
+
+		struct PendingRecord {
+			int64_t timestamp;
+			Level level;
+			std::string message;
+		};
+
+		// Formats everything currently in the rings, oldest first across threads.
+		static void Drain(Sink target) {
+			std::vector<std::shared_ptr<ThreadRing>> snapshot;
+			{
+				std::lock_guard lock(ringsMutex);
+				snapshot = rings;
+			}
+
+			std::vector<PendingRecord> pending;
+			for (const auto& ring : snapshot) {
+				size_t tail = ring->tail.load(std::memory_order_relaxed);
+				size_t head = ring->head.load(std::memory_order_acquire);
+
+				while (tail != head) {
+					const std::byte* record = ring->data + tail % RING_BUFFER_BYTES;
+					uint32_t size;
+					std::memcpy(&size, record, sizeof(size));
+
+					if (size == PADDING_RECORD) {
+						tail += RING_BUFFER_BYTES - tail % RING_BUFFER_BYTES;
+						continue;
+					}
+
+					RecordHeader header;
+					std::memcpy(&header, record, sizeof(header));
+
+					PendingRecord formatted{ header.timestamp, header.level, {} };
+					try {
+						header.format(std::string_view(header.formatData, header.formatSize), record + sizeof(RecordHeader), formatted.message);
+					}
+					catch (const std::exception& e) {
+						formatted.message = std::string("DeferredLog: failed to format record: ") + e.what();
+					}
+					pending.push_back(std::move(formatted));
+
+					tail += (size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+				}
+				ring->tail.store(tail, std::memory_order_release);
+			}
+
+			std::stable_sort(pending.begin(), pending.end(), [](const PendingRecord& a, const PendingRecord& b) {
+				return a.timestamp < b.timestamp;
+			});
+
+			if (target) {
+				for (const auto& record : pending) {
+					target(record.level, record.message);
+				}
+			}
+
+			// Rings of exited threads are only referenced here once drained.
+			std::lock_guard lock(ringsMutex);
+			std::erase_if(rings, [](const std::shared_ptr<ThreadRing>& ring) {
+				return ring.use_count() == 1 && ring->head.load() == ring->tail.load();
+			});
+		}
+
+		static void FormatterLoop() {
+			uint64_t lastReportedDrops = 0;
+			while (true) {
+				uint64_t generation;
+				bool stopping;
+				Sink target;
+				{
+					std::unique_lock lock(stateMutex);
+					wakeFormatter.wait_for(lock, FLUSH_INTERVAL, [] {
+						return stopRequested || flushGeneration != completedGeneration || drainRequested.load(std::memory_order_relaxed);
+						});
+					drainRequested.store(false, std::memory_order_relaxed);
+					generation = flushGeneration;
+					stopping = stopRequested;
+					target = sink;
+				}
+
+				Drain(target);
+
+				uint64_t drops = droppedCount.load(std::memory_order_relaxed);
+				if (drops != lastReportedDrops && target) {
+					target(Level::Warn, std::format("DeferredLog: {} record(s) dropped because a thread's ring was full.", drops - lastReportedDrops));
+					lastReportedDrops = drops;
+				}
+
+				{
+					std::lock_guard lock(stateMutex);
+					completedGeneration = generation;
+					if (stopping) {
+						running = false;
+					}
+					// Notified under the lock: once running is false, Shutdown() may return and the process exit.
+					flushed.notify_all();
+				}
+
+				if (stopping) return;
+			}
+		}
+	}
+
+	void Start(Sink newSink) {
+		std::lock_guard lock(detail::stateMutex);
+		detail::sink = newSink;
+		if (detail::running) return;
+
+		detail::running = true;
+		detail::stopRequested = false;
+		// Detached so a missing Shutdown() on process exit cannot terminate() or deadlock in a static destructor.
+		std::thread(detail::FormatterLoop).detach();
+	}
+
+	void Flush() {
+		std::unique_lock lock(detail::stateMutex);
+		if (!detail::running) return;
+
+		uint64_t target = ++detail::flushGeneration;
+		detail::wakeFormatter.notify_one();
+		detail::flushed.wait_for(lock, std::chrono::seconds(1), [target] {
+			return detail::completedGeneration >= target || !detail::running;
+		});
+	}
+
+	void Shutdown() {
+		std::unique_lock lock(detail::stateMutex);
+		if (!detail::running) return;
+
+		detail::stopRequested = true;
+		detail::wakeFormatter.notify_one();
+		detail::flushed.wait_for(lock, std::chrono::seconds(1), [] { return !detail::running; });
+	}
+
+	Stats GetStats() {
+		return {
+			detail::writtenCount.load(std::memory_order_relaxed),
+			detail::droppedCount.load(std::memory_order_relaxed),
+			detail::oversizedCount.load(std::memory_order_relaxed)
+		};
+	}
+}
@@ -0,0 +1,222 @@
+﻿#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+// Deferred logging for hot paths.
+//
+// A call checks the level (one relaxed load and a branch), then copies its arguments in binary
+// form into a ring owned by the calling thread. A background thread formats the records and hands
+// the text to the sink, so the caller never runs std::format or touches the log file.
+//
+// Arguments must be arithmetic, enums, pointers or strings. Strings are copied, so temporaries
+// are fine. Format strings are checked at compile time like std::format.
+namespace DeferredLog {
+	enum class Level : uint8_t {
+		Trace,
+		Debug,
+		Info,
+		Warn,
+		Error,
+		Critical,
+		Off
+	};
+
+	using Sink = void (*)(Level level, std::string_view message);
+
+	// Each thread's ring. Records that do not fit are dropped and counted.
+	constexpr size_t RING_BUFFER_BYTES = 64 * 1024;
+	// Records larger than this are formatted and sunk synchronously instead.
+	constexpr size_t MAX_RECORD_BYTES = RING_BUFFER_BYTES / 4;
+	constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds(50);
+
+	struct Stats {
+		uint64_t written = 0;
+		uint64_t dropped = 0;
+		uint64_t oversized = 0;
+	};
+
+	void Start(Sink sink);
+	// Drains every ring and stops the formatter thread.
+	void Shutdown();
+	// Blocks until everything logged so far has reached the sink.
+	void Flush();
+	Stats GetStats();
+
+	namespace detail {
+		inline std::atomic<Level> minLevel{ Level::Info };
+
+		using FormatFn = void (*)(std::string_view format, const std::byte* payload, std::string& out);
+
+		struct RecordHeader {
+			uint32_t size;
+			Level level;
+			FormatFn format;
+			const char* formatData;
+			uint32_t formatSize;
+			int64_t timestamp;
+		};
+
+		// Reserves size bytes in the calling thread's ring, nullptr if it is full.
+		std::byte* Reserve(size_t size);
+		void Commit(std::byte* record);
+		void WriteDirect(Level level, std::string_view message);
+
+		template <typename T>
+		constexpr bool IsString = std::is_convertible_v<const T&, std::string_view>;
+
+		template <typename T>
+		using Stored = std::conditional_t<IsString<T>, std::string_view, std::remove_cvref_t<T>>;
+
+		template <typename T>
+		std::string_view AsText(const T& value) {
+			if constexpr (std::is_pointer_v<std::decay_t<T>>) {
+				if (!value) return "(null)";
+			}
+			return std::string_view(value);
+		}
+
+		template <typename T>
+		size_t EncodedSize(const T& value) {
+			if constexpr (IsString<T>) {
+				return sizeof(uint32_t) + AsText(value).size();
+			}
+			else {
+				static_assert(std::is_trivially_copyable_v<T>, "DeferredLog arguments must be arithmetic, enums, pointers or strings");
+				return sizeof(T);
+			}
+		}
+
+		template <typename T>
+		std::byte* Encode(std::byte* out, const T& value) {
+			if constexpr (IsString<T>) {
+				std::string_view text = AsText(value);
+				uint32_t length = static_cast<uint32_t>(text.size());
+				std::memcpy(out, &length, sizeof(length));
+				std::memcpy(out + sizeof(length), text.data(), length);
+				return out + sizeof(length) + length;
+			}
+			else {
+				std::memcpy(out, &value, sizeof(T));
+				return out + sizeof(T);
+			}
+		}
+
+		template <typename T>
+		T Decode(const std::byte*& in) {
+			if constexpr (std::is_same_v<T, std::string_view>) {
+				uint32_t length;
+				std::memcpy(&length, in, sizeof(length));
+				std::string_view text(reinterpret_cast<const char*>(in + sizeof(length)), length);
+				in += sizeof(length) + length;
+				return text;
+			}
+			else {
+				T value;
+				std::memcpy(&value, in, sizeof(T));
+				in += sizeof(T);
+				return value;
+			}
+		}
+
+		template <typename... Ts>
+		void FormatPayload(std::string_view format, [[maybe_unused]] const std::byte* payload, std::string& out) {
+			// Braced initialization evaluates left to right, matching the encode order.
+			std::tuple<Ts...> values{ Decode<Ts>(payload)... };
+			std::apply([&](auto&... args) {
+				out = std::vformat(format, std::make_format_args(args...));
+				}, values);
+		}
+
+		template <typename... Args>
+		void Write(Level level, std::format_string<Args...> format, const Args&... args) {
+			size_t size = sizeof(RecordHeader) + (EncodedSize(args) + ... + 0);
+
+			if (size > MAX_RECORD_BYTES) {
+				WriteDirect(level, std::vformat(format.get(), std::make_format_args(args...)));
+				return;
+			}
+
+			std::byte* record = Reserve(size);
+			if (!record) return;
+
+			std::string_view formatText = format.get();
+			RecordHeader header{
+				static_cast<uint32_t>(size),
+				level,
+				&FormatPayload<Stored<Args>...>,
+				formatText.data(),
+				static_cast<uint32_t>(formatText.size()),
+				std::chrono::steady_clock::now().time_since_epoch().count()
+			};
+			std::memcpy(record, &header, sizeof(header));
+
+			[[maybe_unused]] std::byte* cursor = record + sizeof(RecordHeader);
+			((cursor = Encode(cursor, args)), ...);
+
+			Commit(record);
+		}
+	}
+
+	inline void SetLevel(Level level) {
+		detail::minLevel.store(level, std::memory_order_relaxed);
+	}
+
+	inline Level GetLevel() {
+		return detail::minLevel.load(std::memory_order_relaxed);
+	}
+
+	inline bool IsEnabled(Level level) {
+		return level >= detail::minLevel.load(std::memory_order_relaxed);
+	}
+
+	template <typename... Args>
+	void log(Level level, std::format_string<Args...> format, const Args&... args) {
+		if (!IsEnabled(level)) return;
+		detail::Write(level, format, args...);
+	}
+
+	template <typename... Args>
+	void trace(std::format_string<Args...> format, const Args&... args) {
+		if (!IsEnabled(Level::Trace)) return;
+		detail::Write(Level::Trace, format, args...);
+	}
+
+	template <typename... Args>
+	void debug(std::format_string<Args...> format, const Args&... args) {
+		if (!IsEnabled(Level::Debug)) return;
+		detail::Write(Level::Debug, format, args...);
+	}
+
+	template <typename... Args>
+	void info(std::format_string<Args...> format, const Args&... args) {
+		if (!IsEnabled(Level::Info)) return;
+		detail::Write(Level::Info, format, args...);
+	}
+
+	template <typename... Args>
+	void warn(std::format_string<Args...> format, const Args&... args) {
+		if (!IsEnabled(Level::Warn)) return;
+		detail::Write(Level::Warn, format, args...);
+	}
+
+	template <typename... Args>
+	void error(std::format_string<Args...> format, const Args&... args) {
+		if (!IsEnabled(Level::Error)) return;
+		detail::Write(Level::Error, format, args...);
+	}
+
+	template <typename... Args>
+	void critical(std::format_string<Args...> format, const Args&... args) {
+		if (!IsEnabled(Level::Critical)) return;
+		detail::Write(Level::Critical, format, args...);
+	}
+}
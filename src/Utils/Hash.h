@@ -0,0 +1,16 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// 64-bit FNV-1a. Fast and good enough to find candidate duplicates, not collision resistant:
+// callers that dedupe by hash must still compare contents.
+inline uint64_t Fnv1a64(const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
@@ -0,0 +1,117 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Free resources kept for reuse, bucketed by an exact key (for textures: width, height and format).
+// acquire() hands out the most recently returned resource of a bucket; release() puts one back and
+// frees least recently returned resources of any bucket while the pool holds more than its capacity.
+//
+// Only bookkeeping lives here, resources are freed through the releaser given to the constructor,
+// so the pool works the same with D3D textures and with plain values. Not thread-safe.
+template <typename Key, typename Resource>
+class ResourcePool {
+public:
+    using Releaser = std::function<void(Resource&)>;
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        // Resources freed to stay under capacity, by trim() or by clear().
+        uint64_t evictions = 0;
+        uint64_t pooledBytes = 0;
+        uint32_t pooledCount = 0;
+    };
+
+    ResourcePool(uint64_t capacityBytes, Releaser releaser)
+        : capacity_(capacityBytes), releaser_(std::move(releaser)) {}
+
+    ~ResourcePool() { clear(); }
+
+    ResourcePool(const ResourcePool&) = delete;
+    ResourcePool& operator=(const ResourcePool&) = delete;
+
+    std::optional<Resource> acquire(const Key& key) {
+        auto bucket = buckets_.find(key);
+        if (bucket == buckets_.end() || bucket->second.empty()) {
+            stats_.misses++;
+            return std::nullopt;
+        }
+
+        auto entry = bucket->second.back();
+        bucket->second.pop_back();
+        if (bucket->second.empty()) buckets_.erase(bucket);
+
+        Resource resource = std::move(entry->resource);
+        stats_.pooledBytes -= entry->bytes;
+        stats_.pooledCount--;
+        stats_.hits++;
+        lru_.erase(entry);
+        return resource;
+    }
+
+    // bytes is what the resource occupies, it counts against the capacity while pooled.
+    void release(const Key& key, Resource resource, uint64_t bytes) {
+        if (bytes > capacity_) {
+            releaser_(resource);
+            stats_.evictions++;
+            return;
+        }
+
+        lru_.push_front({ key, std::move(resource), bytes });
+        buckets_[key].push_back(lru_.begin());
+        stats_.pooledBytes += bytes;
+        stats_.pooledCount++;
+        trim(capacity_);
+    }
+
+    // Frees least recently returned resources until at most capacityBytes are pooled.
+    void trim(uint64_t capacityBytes) {
+        while (!lru_.empty() && stats_.pooledBytes > capacityBytes) {
+            auto entry = std::prev(lru_.end());
+
+            // The oldest entry of a bucket is its first element.
+            auto bucket = buckets_.find(entry->key);
+            bucket->second.erase(bucket->second.begin());
+            if (bucket->second.empty()) buckets_.erase(bucket);
+
+            releaser_(entry->resource);
+            stats_.pooledBytes -= entry->bytes;
+            stats_.pooledCount--;
+            stats_.evictions++;
+            lru_.erase(entry);
+        }
+    }
+
+    void clear() { trim(0); }
+
+    void set_capacity(uint64_t capacityBytes) {
+        capacity_ = capacityBytes;
+        trim(capacity_);
+    }
+
+    uint64_t capacity() const { return capacity_; }
+    Stats get_stats() const { return stats_; }
+
+private:
+    struct Entry {
+        Key key;
+        Resource resource;
+        uint64_t bytes;
+    };
+    using EntryIterator = typename std::list<Entry>::iterator;
+
+    uint64_t capacity_;
+    Releaser releaser_;
+    // Most recently returned first.
+    std::list<Entry> lru_;
+    // Oldest first within a bucket.
+    std::map<Key, std::vector<EntryIterator>> buckets_;
+    Stats stats_;
+};
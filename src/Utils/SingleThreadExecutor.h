@@ -3,15 +3,50 @@
 #include <thread>
 #include <mutex>
 #include <condition_variable>
-#include <queue>
+#include <deque>
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <future>
 #include <stdexcept>
 #include <utility>
 #include <type_traits>
 
+// Lanes of SingleThreadExecutor, highest priority first.
+enum class TaskPriority : uint8_t {
+    Input,
+    Render,
+    Interop,
+    Background,
+    Count
+};
+
+struct ExecutorLaneStats {
+    uint32_t depth = 0;
+    uint32_t peakDepth = 0;
+    uint64_t executed = 0;
+    // Tasks run ahead of higher lanes because they waited longer than STARVATION_LIMIT,
+    // or because a task picked before them shares their order key.
+    uint64_t promoted = 0;
+    double maxWaitMs = 0.0;
+    double totalWaitMs = 0.0;
+};
+
+// Runs tasks on one thread. The highest non-empty lane runs first, FIFO within a lane;
+// a task that waited longer than STARVATION_LIMIT runs next regardless of its lane.
+// Tasks submitted with an order key never overtake earlier tasks with the same key, whatever
+// their lanes: when one is picked, the earliest queued task it must not pass runs instead.
 class SingleThreadExecutor {
 public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr size_t LANE_COUNT = static_cast<size_t>(TaskPriority::Count);
+    static constexpr auto STARVATION_LIMIT = std::chrono::milliseconds(100);
+    // Task without ordering constraints.
+    static constexpr uint64_t NO_ORDER_KEY = 0;
+    // Ordered against every keyed task, for work that touches all of them.
+    static constexpr uint64_t ALL_ORDER_KEYS = UINT64_MAX;
+
     SingleThreadExecutor();
     ~SingleThreadExecutor();
 
@@ -20,8 +55,21 @@ public:
     SingleThreadExecutor(SingleThreadExecutor&&) = delete;
     SingleThreadExecutor& operator=(SingleThreadExecutor&&) = delete;
 
+    // Submits to the Render lane.
     template<typename F, typename... Args>
     auto submit(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>>
+    {
+        return submit(TaskPriority::Render, std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    template<typename F, typename... Args>
+    auto submit(TaskPriority priority, F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>>
+    {
+        return submit_ordered(priority, NO_ORDER_KEY, std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    template<typename F, typename... Args>
+    auto submit_ordered(TaskPriority priority, uint64_t orderKey, F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>>
     {
         using ReturnType = std::invoke_result_t<F, Args...>;
 
@@ -35,19 +83,42 @@ public:
             if (stop_) {
                 throw std::runtime_error("Executor is stopping");
             }
-            tasks_.emplace([task_ptr]() { (*task_ptr)(); });
+            size_t lane = static_cast<size_t>(priority);
+            lanes_[lane].push_back({ [task_ptr]() { (*task_ptr)(); }, Clock::now(), next_sequence_++, orderKey });
+
+            uint32_t depth = static_cast<uint32_t>(lanes_[lane].size());
+            if (depth > stats_[lane].peakDepth) {
+                stats_[lane].peakDepth = depth;
+            }
         }
         condition_.notify_one();
         return res;
     }
 
+    ExecutorLaneStats get_lane_stats(TaskPriority priority);
+
 private:
+    struct QueuedTask {
+        std::function<void()> fn;
+        Clock::time_point enqueued;
+        uint64_t sequence;
+        uint64_t orderKey;
+    };
+
     void run();
+    // Picks the lane to run from next, queue_mutex_ must be held and at least one lane non-empty.
+    size_t next_lane(Clock::time_point now, bool& promoted) const;
+    // Moves lane/index to the earliest queued task that the picked task must not overtake, if any.
+    void apply_order(size_t& lane, size_t& index) const;
+    static bool must_follow(uint64_t laterKey, uint64_t earlierKey);
+    bool empty() const;
 
     std::thread worker_thread_;
-    std::queue<std::function<void()>> tasks_;
+    std::array<std::deque<QueuedTask>, LANE_COUNT> lanes_;
+    std::array<ExecutorLaneStats, LANE_COUNT> stats_;
     std::mutex queue_mutex_;
     std::condition_variable condition_;
+    uint64_t next_sequence_ = 0;
     bool stop_;
 };
 
@@ -66,17 +137,102 @@ inline SingleThreadExecutor::~SingleThreadExecutor() {
     }
 }
 
+inline ExecutorLaneStats SingleThreadExecutor::get_lane_stats(TaskPriority priority) {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    size_t lane = static_cast<size_t>(priority);
+    ExecutorLaneStats stats = stats_[lane];
+    stats.depth = static_cast<uint32_t>(lanes_[lane].size());
+    return stats;
+}
+
+inline bool SingleThreadExecutor::empty() const {
+    for (const auto& lane : lanes_) {
+        if (!lane.empty()) return false;
+    }
+    return true;
+}
+
+inline size_t SingleThreadExecutor::next_lane(Clock::time_point now, bool& promoted) const {
+    // Oldest starved task among the lower lanes wins, so a steady stream of input cannot stall the rest.
+    size_t starved = LANE_COUNT;
+    for (size_t lane = 1; lane < LANE_COUNT; ++lane) {
+        if (lanes_[lane].empty() || now - lanes_[lane].front().enqueued < STARVATION_LIMIT) continue;
+        if (starved == LANE_COUNT || lanes_[lane].front().enqueued < lanes_[starved].front().enqueued) {
+            starved = lane;
+        }
+    }
+
+    size_t highest = 0;
+    while (lanes_[highest].empty()) {
+        ++highest;
+    }
+
+    promoted = starved != LANE_COUNT && starved != highest;
+    return promoted ? starved : highest;
+}
+
+inline bool SingleThreadExecutor::must_follow(uint64_t laterKey, uint64_t earlierKey) {
+    if (laterKey == NO_ORDER_KEY || earlierKey == NO_ORDER_KEY) return false;
+    return laterKey == earlierKey || laterKey == ALL_ORDER_KEYS || earlierKey == ALL_ORDER_KEYS;
+}
+
+inline void SingleThreadExecutor::apply_order(size_t& lane, size_t& index) const {
+    // Each step moves to a strictly earlier task, so this ends at one nothing else has to run before.
+    while (true) {
+        const QueuedTask& picked = lanes_[lane][index];
+        if (picked.orderKey == NO_ORDER_KEY) return;
+
+        size_t earliestLane = LANE_COUNT;
+        size_t earliestIndex = 0;
+        for (size_t other = 0; other < LANE_COUNT; ++other) {
+            // FIFO within a lane, so only tasks queued before the picked one can be earlier.
+            size_t end = other == lane ? index : lanes_[other].size();
+            for (size_t i = 0; i < end; ++i) {
+                const QueuedTask& queued = lanes_[other][i];
+                if (queued.sequence > picked.sequence) break;
+                if (!must_follow(picked.orderKey, queued.orderKey)) continue;
+                if (earliestLane == LANE_COUNT || queued.sequence < lanes_[earliestLane][earliestIndex].sequence) {
+                    earliestLane = other;
+                    earliestIndex = i;
+                }
+                break;
+            }
+        }
+
+        if (earliestLane == LANE_COUNT) return;
+        lane = earliestLane;
+        index = earliestIndex;
+    }
+}
+
 inline void SingleThreadExecutor::run() {
     while (true) {
         std::function<void()> task;
         {
             std::unique_lock<std::mutex> lock(queue_mutex_);
-            condition_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
-            if (stop_ && tasks_.empty()) {
+            condition_.wait(lock, [this] { return stop_ || !empty(); });
+            if (stop_ && empty()) {
                 return;
             }
-            task = std::move(tasks_.front());
-            tasks_.pop();
+
+            auto now = Clock::now();
+            bool promoted = false;
+            size_t lane = next_lane(now, promoted);
+            size_t pickedLane = lane;
+            size_t index = 0;
+            apply_order(lane, index);
+            if (lane != pickedLane || index != 0) promoted = true;
+
+            QueuedTask& queued = lanes_[lane][index];
+            double waitMs = std::chrono::duration<double, std::milli>(now - queued.enqueued).count();
+            task = std::move(queued.fn);
+            lanes_[lane].erase(lanes_[lane].begin() + index);
+
+            ExecutorLaneStats& stats = stats_[lane];
+            stats.executed++;
+            stats.totalWaitMs += waitMs;
+            if (waitMs > stats.maxWaitMs) stats.maxWaitMs = waitMs;
+            if (promoted) stats.promoted++;
         }
         try {
             task();
@@ -84,4 +240,3 @@ inline void SingleThreadExecutor::run() {
         catch (...) {}
     }
 }
-
@@ -38,6 +38,7 @@ extern "C" DLLEXPORT void* SKSEAPI RequestPluginAPI(const PRISMA_UI_API::Interfa
 
     switch (a_interfaceVersion) {
     case PRISMA_UI_API::InterfaceVersion::V1:
+    case PRISMA_UI_API::InterfaceVersion::V2:
         logger::info("RequestPluginAPI returned the API singleton");
         return static_cast<void*>(api);
     }
@@ -0,0 +1,70 @@
+﻿// DeferredLogBench: measures the per-call cost of DeferredLog against formatting on the caller.
+//
+//   DeferredLogBench [iterations]
+
+#include <Utils/DeferredLog/DeferredLog.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+static std::atomic<uint64_t> sunkBytes = 0;
+
+static void CountingSink(DeferredLog::Level, std::string_view message) {
+    sunkBytes.fetch_add(message.size(), std::memory_order_relaxed);
+}
+
+template <typename F>
+static double NanosecondsPerCall(uint64_t iterations, F&& call) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; i++) {
+        call(i);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+}
+
+int main(int argc, char* argv[])
+{
+    const uint64_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2'000'000;
+    const std::string name = "inventoryUpdated";
+
+    DeferredLog::Start(&CountingSink);
+
+    DeferredLog::SetLevel(DeferredLog::Level::Info);
+    double disabled = NanosecondsPerCall(iterations, [&](uint64_t i) {
+        DeferredLog::debug("EnqueueOperation: Operation enqueued for view [{}]. Queue size: {}", i, 3);
+    });
+
+    DeferredLog::SetLevel(DeferredLog::Level::Trace);
+    // Keep the ring from filling so the enabled numbers measure the write, not drops.
+    double enabled = 0.0;
+    const uint64_t batch = 500;
+    for (uint64_t done = 0; done < iterations; done += batch) {
+        enabled += NanosecondsPerCall(batch, [&](uint64_t i) {
+            DeferredLog::debug("InvokeCppCallback: Looking for callback viewId={}, name={}", done + i, name);
+        }) * batch;
+        DeferredLog::Flush();
+    }
+    enabled /= static_cast<double>(iterations);
+
+    uint64_t sink = 0;
+    double eager = NanosecondsPerCall(iterations, [&](uint64_t i) {
+        std::string text = std::format("InvokeCppCallback: Looking for callback viewId={}, name={}", i, name);
+        sink += text.size();
+    });
+
+    DeferredLog::Shutdown();
+
+    auto stats = DeferredLog::GetStats();
+    std::printf("iterations            %llu\n", static_cast<unsigned long long>(iterations));
+    std::printf("disabled level        %8.2f ns/call\n", disabled);
+    std::printf("deferred (enabled)    %8.2f ns/call\n", enabled);
+    std::printf("std::format on caller %8.2f ns/call\n", eager);
+    std::printf("written %llu, dropped %llu, sunk %llu bytes (%llu)\n",
+        static_cast<unsigned long long>(stats.written), static_cast<unsigned long long>(stats.dropped),
+        static_cast<unsigned long long>(sunkBytes.load()), static_cast<unsigned long long>(sink));
+    return 0;
+}
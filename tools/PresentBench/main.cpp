@@ -0,0 +1,365 @@
+﻿// PresentBench: measures the view bookkeeping PrismaUI does in every D3DPresent. The whole frame
+// compares the old shared_mutex-guarded map scans with the pre-sorted ViewSnapshot; the render
+// thread's passes compare reading PrismaView objects with reading the ViewFrameTable arrays.
+// Rendering and texture uploads are left out, only registry scans, copies and sorting are timed.
+// "cold" runs flush the CPU caches between frames, as the game does between two presents.
+// The last table sweeps the frame-copy worker count over full-screen frames of dirty views.
+//
+//   PresentBench [frames]
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include <Utils/WorkerPool.h>
+
+constexpr size_t MAX_SLOTS = 256;
+
+// Hot fields first, then roughly the size and layout of PrismaView's cold data.
+struct MockView {
+    uint64_t id = 0;
+    uint32_t slot = 0;
+    int order = 0;
+    std::atomic<bool> isHidden = false;
+    std::atomic<bool> isHibernated = false;
+    std::atomic<bool> newFrameReady = false;
+    std::atomic<bool> pendingResourceRelease = false;
+    std::atomic<int> queuedOperationsCount = 0;
+    void* ultralightView = nullptr;
+    void* textureView = nullptr;
+
+    std::string htmlPathToLoad;
+    std::string sessionName;
+    std::function<void(uint64_t)> domReadyCallback;
+    std::vector<std::byte> pixelBuffer;
+    std::mutex bufferMutex;
+    std::mutex operationMutex;
+    std::array<uint16_t, 100> pendingOperations{};
+    std::mutex scriptMutex;
+    std::deque<std::function<void()>> pendingScripts;
+};
+
+struct MockFrameTable {
+    std::array<std::atomic<bool>, MAX_SLOTS> isHidden{};
+    std::array<std::atomic<bool>, MAX_SLOTS> isHibernated{};
+    std::array<std::atomic<bool>, MAX_SLOTS> newFrameReady{};
+    std::array<std::atomic<bool>, MAX_SLOTS> pendingResourceRelease{};
+    std::array<std::atomic<int>, MAX_SLOTS> queuedOperationsCount{};
+    std::array<void*, MAX_SLOTS> textureView{};
+    std::array<int, MAX_SLOTS> order{};
+};
+
+struct MockSnapshot {
+    std::vector<std::shared_ptr<MockView>> views;
+    std::vector<MockView*> drawOrder;
+    std::vector<uint32_t> slots;
+    std::vector<uint32_t> drawSlots;
+};
+
+static std::map<uint64_t, std::shared_ptr<MockView>> views;
+static std::shared_mutex viewsMutex;
+static std::atomic<std::shared_ptr<const MockSnapshot>> snapshot;
+static MockFrameTable frameTable;
+// Other allocations made between views, so views do not sit next to each other on the heap.
+static std::vector<std::unique_ptr<std::byte[]>> heapNoise;
+static uint64_t sink = 0;
+
+static void Populate(size_t count) {
+    views.clear();
+    heapNoise.clear();
+    static int dummy = 0;
+    for (size_t i = 0; i < count; i++) {
+        auto view = std::make_shared<MockView>();
+        view->id = 0x9E3779B97F4A7C15ull * (i + 1);
+        view->slot = static_cast<uint32_t>(i);
+        view->order = static_cast<int>((i * 7) % count);
+        view->isHidden = i % 3 == 2;
+        view->ultralightView = &dummy;
+        view->textureView = &dummy;
+        view->htmlPathToLoad = "file:///Data/PrismaUI/views/mod/index.html";
+        views[view->id] = view;
+        heapNoise.push_back(std::make_unique<std::byte[]>(4096));
+
+        frameTable.isHidden[i] = view->isHidden.load();
+        frameTable.isHibernated[i] = false;
+        frameTable.newFrameReady[i] = false;
+        frameTable.pendingResourceRelease[i] = false;
+        frameTable.textureView[i] = view->textureView;
+        frameTable.order[i] = view->order;
+    }
+
+    auto built = std::make_shared<MockSnapshot>();
+    for (const auto& pair : views) {
+        built->views.push_back(pair.second);
+        built->drawOrder.push_back(pair.second.get());
+        built->slots.push_back(pair.second->slot);
+    }
+    std::stable_sort(built->drawOrder.begin(), built->drawOrder.end(), [](const MockView* a, const MockView* b) {
+        return a->order < b->order;
+    });
+    built->drawSlots = built->slots;
+    std::stable_sort(built->drawSlots.begin(), built->drawSlots.end(), [](uint32_t a, uint32_t b) {
+        return frameTable.order[a] < frameTable.order[b];
+    });
+    snapshot.store(std::move(built));
+}
+
+// The scans D3DPresent and its UI task did before the snapshot: pending releases, pending
+// operations, pending creations, RenderActiveViews, RenderViews, texture updates and DrawViews.
+static void MapFrame() {
+    std::vector<uint64_t> pendingRelease;
+    {
+        std::shared_lock lock(viewsMutex);
+        for (const auto& pair : views) {
+            if (pair.second && pair.second->pendingResourceRelease.load()) pendingRelease.push_back(pair.first);
+        }
+    }
+
+    std::vector<uint64_t> operationIds;
+    {
+        std::shared_lock lock(viewsMutex);
+        for (const auto& pair : views) operationIds.push_back(pair.first);
+    }
+    for (uint64_t id : operationIds) {
+        std::shared_ptr<MockView> view;
+        {
+            std::shared_lock lock(viewsMutex);
+            auto it = views.find(id);
+            if (it != views.end()) view = it->second;
+        }
+        if (view) sink += view->queuedOperationsCount.load();
+    }
+
+    std::vector<std::shared_ptr<MockView>> pendingCreation;
+    {
+        std::shared_lock lock(viewsMutex);
+        for (const auto& pair : views) {
+            if (pair.second && !pair.second->ultralightView) pendingCreation.push_back(pair.second);
+        }
+    }
+
+    std::vector<void*> active;
+    {
+        std::shared_lock lock(viewsMutex);
+        for (const auto& pair : views) {
+            if (pair.second && pair.second->ultralightView && !pair.second->isHibernated) active.push_back(pair.second->ultralightView);
+        }
+    }
+
+    std::vector<std::shared_ptr<MockView>> toRender;
+    {
+        std::shared_lock lock(viewsMutex);
+        for (const auto& pair : views) {
+            if (pair.second && !pair.second->isHidden) toRender.push_back(pair.second);
+        }
+    }
+
+    std::vector<std::shared_ptr<MockView>> toCheck;
+    {
+        std::shared_lock lock(viewsMutex);
+        for (const auto& pair : views) {
+            if (pair.second && pair.second->ultralightView) toCheck.push_back(pair.second);
+        }
+    }
+
+    std::vector<std::shared_ptr<MockView>> toDraw;
+    {
+        std::shared_lock lock(viewsMutex);
+        for (const auto& pair : views) {
+            if (pair.second && !pair.second->isHidden.load() && !pair.second->pendingResourceRelease.load() && pair.second->textureView) {
+                toDraw.push_back(pair.second);
+            }
+        }
+    }
+    std::sort(toDraw.begin(), toDraw.end(), [](const std::shared_ptr<MockView>& a, const std::shared_ptr<MockView>& b) {
+        return a->order < b->order;
+    });
+
+    sink += pendingRelease.size() + pendingCreation.size() + active.size() + toRender.size() + toCheck.size();
+    for (const auto& view : toDraw) sink += view->id;
+}
+
+// The UI task's passes, identical for both snapshot layouts: they need ultralightView either way.
+static void SnapshotUiPasses(const MockSnapshot& frame) {
+    size_t count = 0;
+    for (const auto& view : frame.views) {
+        if (!view->ultralightView) count++;
+    }
+
+    static std::vector<void*> active;
+    active.clear();
+    for (const auto& view : frame.views) {
+        if (view->ultralightView && !view->isHibernated) active.push_back(view->ultralightView);
+    }
+
+    for (const auto& view : frame.views) {
+        if (!view->isHidden) count++;
+    }
+    sink += count + active.size();
+}
+
+// The render thread's passes over the views of the snapshot: pending releases, queued
+// operations, texture updates and the draw loop.
+static void SnapshotRenderPasses(const MockSnapshot& frame) {
+    for (const auto& view : frame.views) {
+        if (view->pendingResourceRelease.load()) sink++;
+    }
+    for (const auto& view : frame.views) {
+        if (view->queuedOperationsCount.load(std::memory_order_relaxed) > 0) sink++;
+    }
+    for (const auto& view : frame.views) {
+        if (view->ultralightView && view->newFrameReady.load(std::memory_order_relaxed)) sink++;
+    }
+    for (const MockView* view : frame.drawOrder) {
+        if (!view->isHidden.load() && !view->pendingResourceRelease.load() && view->textureView) sink += view->slot;
+    }
+}
+
+// The same passes reading the frame table instead of the views.
+static void FrameTableRenderPasses(const MockSnapshot& frame) {
+    for (uint32_t slot : frame.slots) {
+        if (frameTable.pendingResourceRelease[slot].load()) sink++;
+    }
+    for (uint32_t slot : frame.slots) {
+        if (frameTable.queuedOperationsCount[slot].load(std::memory_order_relaxed) > 0) sink++;
+    }
+    for (uint32_t slot : frame.slots) {
+        if (frameTable.newFrameReady[slot].load(std::memory_order_relaxed)) sink++;
+    }
+    for (uint32_t slot : frame.drawSlots) {
+        if (!frameTable.isHidden[slot].load() && !frameTable.pendingResourceRelease[slot].load() && frameTable.textureView[slot]) sink += slot;
+    }
+}
+
+// One snapshot, captured once per frame and shared with the UI task.
+static void SnapshotFrame() {
+    const auto frame = snapshot.load(std::memory_order_acquire);
+    SnapshotRenderPasses(*frame);
+    SnapshotUiPasses(*frame);
+}
+
+static void SnapshotRenderFrame() {
+    SnapshotRenderPasses(*snapshot.load(std::memory_order_acquire));
+}
+
+static void FrameTableRenderFrame() {
+    FrameTableRenderPasses(*snapshot.load(std::memory_order_acquire));
+}
+
+template <typename F>
+static double NanosecondsPerFrame(uint64_t frames, F&& frame) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < frames; i++) {
+        frame();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(frames);
+}
+
+// Walks a buffer larger than the last-level cache before every frame and times the frame alone.
+template <typename F>
+static double ColdNanosecondsPerFrame(uint64_t frames, F&& frame) {
+    static std::vector<uint64_t> evict(64 * 1024 * 1024 / sizeof(uint64_t), 1);
+    double total = 0.0;
+    for (uint64_t i = 0; i < frames; i++) {
+        for (size_t j = 0; j < evict.size(); j += 8) sink += evict[j]++;
+        auto start = std::chrono::steady_clock::now();
+        frame();
+        total += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+    return total / static_cast<double>(frames);
+}
+
+template <typename... F>
+static void PrintRows(uint64_t frames, const char* const (&columns)[sizeof...(F)], F... passes) {
+    const uint64_t coldFrames = std::max<uint64_t>(frames / 200, 20);
+
+    std::printf("%-6s %8s", "", "views");
+    for (const char* column : columns) std::printf(" %16s", column);
+    std::printf("\n");
+
+    for (bool cold : { false, true }) {
+        for (size_t count : { 1, 10, 50 }) {
+            Populate(count);
+            std::printf("%-6s %8zu", cold ? "cold" : "warm", count);
+            for (auto pass : { passes... }) {
+                double ns;
+                if (cold) {
+                    ns = ColdNanosecondsPerFrame(coldFrames, pass);
+                }
+                else {
+                    NanosecondsPerFrame(frames / 10, pass);
+                    ns = NanosecondsPerFrame(frames, pass);
+                }
+                std::printf(" %16.1f", ns);
+            }
+            std::printf("\n");
+        }
+    }
+}
+
+// ViewRenderer's frame copy: every dirty view's locked bitmap is copied into its pixel buffer,
+// on the calling thread with one worker and fanned out to the pool otherwise.
+static double FrameCopyMilliseconds(size_t workerCount, size_t dirtyViews, uint32_t frames) {
+    constexpr size_t FRAME_BYTES = 1920 * 1080 * 4;
+    std::vector<std::vector<std::byte>> bitmaps(dirtyViews, std::vector<std::byte>(FRAME_BYTES, std::byte{ 1 }));
+    std::vector<std::vector<std::byte>> buffers(dirtyViews, std::vector<std::byte>(FRAME_BYTES));
+    std::unique_ptr<WorkerPool> pool = workerCount > 1 ? std::make_unique<WorkerPool>(workerCount) : nullptr;
+
+    auto copyFrame = [&]() {
+        if (!pool) {
+            for (size_t i = 0; i < dirtyViews; i++) std::memcpy(buffers[i].data(), bitmaps[i].data(), FRAME_BYTES);
+            return;
+        }
+        std::vector<std::future<void>> copies;
+        for (size_t i = 0; i < dirtyViews; i++) {
+            copies.push_back(pool->submit([&, i]() { std::memcpy(buffers[i].data(), bitmaps[i].data(), FRAME_BYTES); }));
+        }
+        for (auto& copy : copies) copy.get();
+    };
+
+    copyFrame();
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < frames; i++) copyFrame();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    for (const auto& buffer : buffers) sink += static_cast<uint64_t>(buffer[FRAME_BYTES / 2]);
+    return std::chrono::duration<double, std::milli>(elapsed).count() / frames;
+}
+
+int main(int argc, char* argv[])
+{
+    const uint64_t frames = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+
+    std::printf("Whole frame, ns per frame\n");
+    PrintRows(frames, { "map", "snapshot" }, &MapFrame, &SnapshotFrame);
+
+    std::printf("\nRender thread passes, ns per frame\n");
+    PrintRows(frames, { "PrismaView", "frame table" }, &SnapshotRenderFrame, &FrameTableRenderFrame);
+
+    std::printf("\nFrame copy of 1920x1080 views, ms per frame\n");
+    std::printf("%-14s", "dirty views");
+    for (size_t workers : { 1, 2, 4, 8 }) std::printf(" %10zu wkr", workers);
+    std::printf("\n");
+    for (size_t dirtyViews : { 1, 2, 4, 8 }) {
+        std::printf("%-14zu", dirtyViews);
+        for (size_t workers : { 1, 2, 4, 8 }) std::printf(" %14.2f", FrameCopyMilliseconds(workers, dirtyViews, 50));
+        std::printf("\n");
+    }
+
+    std::printf("checksum %llu\n", static_cast<unsigned long long>(sink));
+    return 0;
+}
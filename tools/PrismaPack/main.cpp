@@ -0,0 +1,140 @@
+﻿// PrismaPack: builds a .prismapack archive from a folder laid out like the game's Data folder.
+//
+//   PrismaPack <data folder> <output.prismapack>
+//
+// Example: PrismaPack "MyMod" "MyMod/PrismaUI/packs/MyMod.prismapack" packs everything under
+// MyMod/PrismaUI/views/... so it is served at file:///Data/PrismaUI/views/...
+
+#include <PrismaUI/PackFormat.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace PrismaUI;
+
+struct SourceFile {
+    fs::path sourcePath;
+    std::string packedPath;
+    std::string mimeType;
+    uint64_t dataOffset = 0;
+    uint64_t dataSize = 0;
+};
+
+static void WritePadding(std::ofstream& out, uint64_t& offset) {
+    static const char zeros[PackFormat::DATA_ALIGNMENT] = {};
+    uint64_t padding = (PackFormat::DATA_ALIGNMENT - offset % PackFormat::DATA_ALIGNMENT) % PackFormat::DATA_ALIGNMENT;
+    out.write(zeros, static_cast<std::streamsize>(padding));
+    offset += padding;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3) {
+        std::fprintf(stderr, "Usage: PrismaPack <data folder> <output%s>\n", PackFormat::FILE_EXTENSION);
+        return 1;
+    }
+
+    const fs::path inputRoot = fs::absolute(argv[1]);
+    const fs::path outputPath = fs::absolute(argv[2]);
+
+    std::error_code ec;
+    if (!fs::is_directory(inputRoot, ec)) {
+        std::fprintf(stderr, "PrismaPack: %s is not a directory.\n", inputRoot.string().c_str());
+        return 1;
+    }
+
+    std::vector<SourceFile> files;
+    for (const auto& item : fs::recursive_directory_iterator(inputRoot)) {
+        if (!item.is_regular_file()) continue;
+        if (fs::equivalent(item.path(), outputPath, ec)) continue;
+        if (PackFormat::NormalizePath(item.path().extension().string()) == PackFormat::FILE_EXTENSION) continue;
+
+        SourceFile file;
+        file.sourcePath = item.path();
+        file.packedPath = PackFormat::NormalizePath(fs::relative(item.path(), inputRoot).generic_string());
+        file.mimeType = PackFormat::MimeTypeFromPath(file.packedPath);
+        file.dataSize = item.file_size();
+        files.push_back(std::move(file));
+    }
+
+    std::sort(files.begin(), files.end(), [](const SourceFile& a, const SourceFile& b) {
+        return a.packedPath < b.packedPath;
+    });
+
+    for (size_t i = 1; i < files.size(); i++) {
+        if (files[i].packedPath == files[i - 1].packedPath) {
+            std::fprintf(stderr, "PrismaPack: %s and %s collide (paths are case-insensitive).\n",
+                files[i - 1].sourcePath.string().c_str(), files[i].sourcePath.string().c_str());
+            return 1;
+        }
+    }
+
+    std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::fprintf(stderr, "PrismaPack: Cannot write %s.\n", outputPath.string().c_str());
+        return 1;
+    }
+
+    PackFormat::PackHeader header{};
+    std::memcpy(header.magic, PackFormat::MAGIC, sizeof(header.magic));
+    header.version = PackFormat::VERSION;
+    header.entryCount = static_cast<uint32_t>(files.size());
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    uint64_t offset = sizeof(header);
+    std::vector<char> chunk(1 << 20);
+    for (auto& file : files) {
+        WritePadding(out, offset);
+        file.dataOffset = offset;
+
+        std::ifstream in(file.sourcePath, std::ios::binary);
+        if (!in) {
+            std::fprintf(stderr, "PrismaPack: Cannot read %s.\n", file.sourcePath.string().c_str());
+            return 1;
+        }
+
+        uint64_t copied = 0;
+        while (in) {
+            in.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            std::streamsize read = in.gcount();
+            if (read <= 0) break;
+            out.write(chunk.data(), read);
+            copied += static_cast<uint64_t>(read);
+        }
+        file.dataSize = copied;
+        offset += copied;
+    }
+
+    header.indexOffset = offset;
+    for (const auto& file : files) {
+        PackFormat::PackIndexEntry entry{};
+        entry.dataOffset = file.dataOffset;
+        entry.dataSize = file.dataSize;
+        entry.pathLength = static_cast<uint32_t>(file.packedPath.size());
+        entry.mimeTypeLength = static_cast<uint32_t>(file.mimeType.size());
+        out.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        out.write(file.packedPath.data(), static_cast<std::streamsize>(file.packedPath.size()));
+        out.write(file.mimeType.data(), static_cast<std::streamsize>(file.mimeType.size()));
+        offset += sizeof(entry) + file.packedPath.size() + file.mimeType.size();
+    }
+    header.indexSize = offset - header.indexOffset;
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+
+    if (!out) {
+        std::fprintf(stderr, "PrismaPack: Failed while writing %s.\n", outputPath.string().c_str());
+        return 1;
+    }
+
+    std::printf("PrismaPack: Packed %zu file(s) into %s (%llu bytes).\n",
+        files.size(), outputPath.string().c_str(), static_cast<unsigned long long>(offset));
+    return 0;
+}
@@ -0,0 +1,137 @@
+﻿// ReducerCheck: verifies ViewOperationReducer's fold table against the unreduced operation model.
+//
+//   ReducerCheck [max sequence length]
+//
+// Exits with 1 when a reduced queue can end in a different state than the operations it replaced.
+
+#include <PrismaUI/ViewOperationReducer.h>
+
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace PrismaUI::ViewOperationReducer;
+
+constexpr size_t ALPHABET = static_cast<size_t>(Symbol::End);
+constexpr size_t MAX_SEQUENCE_LENGTH = 8;
+
+// A queue of symbols reduced the way EnqueueOperation reduces the real ring.
+struct ModelQueue {
+    std::array<Symbol, 2 * MAX_SEQUENCE_LENGTH> symbols{};
+    size_t length = 0;
+
+    void Push(Symbol symbol) {
+        if (IsBarrier(symbol)) {
+            symbols[length++] = symbol;
+            return;
+        }
+        size_t tailStart = length;
+        while (tailStart > 0 && !IsBarrier(symbols[tailStart - 1])) {
+            --tailStart;
+        }
+        std::array<Symbol, MAX_FOLDED_LENGTH + 1> folded{};
+        size_t foldedLength = Fold(symbols.data() + tailStart, length - tailStart, symbol, folded.data());
+        for (size_t i = 0; i < foldedLength; ++i) {
+            symbols[tailStart + i] = folded[i];
+        }
+        length = tailStart + foldedLength;
+    }
+};
+
+// Folding any reachable tail with any foldable symbol stays exact, so queues of any length reduce correctly.
+static bool CheckEveryFold() {
+    const FoldTable& table = GetFoldTable();
+    for (size_t index = 0; index < table.sequences.size(); ++index) {
+        const FoldedSequence& tail = table.sequences[index];
+
+        for (size_t x = 0; x < SYMBOL_COUNT; ++x) {
+            std::array<Symbol, MAX_FOLDED_LENGTH + 1> folded{};
+            size_t foldedLength = Fold(tail.symbols.data(), tail.length, static_cast<Symbol>(x), folded.data());
+            Function expected = Then(Evaluate(tail.symbols.data(), tail.length), static_cast<Symbol>(x));
+            if (Evaluate(folded.data(), foldedLength) != expected || foldedLength > MAX_FOLDED_LENGTH) {
+                std::printf("fold of table entry %zu with symbol %zu changes the final state\n", index, x);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// The model must match ViewManager::ApplyOperation on a view whose Ultralight view does not exist yet:
+// only Show and Hide do anything there.
+static bool CheckUncreatedView() {
+    for (size_t x = 0; x < ALPHABET; ++x) {
+        Symbol symbol = static_cast<Symbol>(x);
+        State fromVisible = Apply(State::UncreatedVisible, symbol);
+        State fromHidden = Apply(State::UncreatedHidden, symbol);
+        State expectedFromVisible = symbol == Symbol::Hide ? State::UncreatedHidden : State::UncreatedVisible;
+        State expectedFromHidden = symbol == Symbol::Show ? State::UncreatedVisible : State::UncreatedHidden;
+        if (fromVisible != expectedFromVisible || fromHidden != expectedFromHidden) {
+            std::printf("symbol %zu on an uncreated view does not match ApplyOperation\n", x);
+            return false;
+        }
+    }
+
+    // Hide, Hibernate must leave an uncreated view hidden; Hibernate alone must not hide it.
+    const Symbol hideThenHibernate[] = { Symbol::Hide, Symbol::Hibernate };
+    ModelQueue reduced;
+    for (Symbol symbol : hideThenHibernate) reduced.Push(symbol);
+    if (Evaluate(reduced.symbols.data(), reduced.length)[static_cast<size_t>(State::UncreatedVisible)] != State::UncreatedHidden) {
+        std::printf("Hide, Hibernate on an uncreated view does not hide it after reduction\n");
+        return false;
+    }
+    return true;
+}
+
+// Every sequence of up to maxLength operations (barriers included), reduced step by step, must end
+// in the same state as the unreduced sequence from every starting state and never grow.
+static bool CheckAllSequences(size_t maxLength, size_t& checked) {
+    for (size_t length = 0; length <= maxLength; ++length) {
+        size_t combinations = 1;
+        for (size_t i = 0; i < length; ++i) combinations *= ALPHABET;
+
+        for (size_t n = 0; n < combinations; ++n) {
+            std::array<Symbol, MAX_SEQUENCE_LENGTH> sequence{};
+            size_t digits = n;
+            ModelQueue reduced;
+            for (size_t i = 0; i < length; ++i) {
+                sequence[i] = static_cast<Symbol>(digits % ALPHABET);
+                digits /= ALPHABET;
+                reduced.Push(sequence[i]);
+            }
+
+            Function expected = Evaluate(sequence.data(), length);
+            Function actual = Evaluate(reduced.symbols.data(), reduced.length);
+            if (expected != actual || reduced.length > length) {
+                std::printf("sequence %zu of length %zu reduces to a different result\n", n, length);
+                return false;
+            }
+            checked++;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t maxLength = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 6;
+    if (maxLength > MAX_SEQUENCE_LENGTH) maxLength = MAX_SEQUENCE_LENGTH;
+
+    const FoldTable& table = GetFoldTable();
+    std::printf("fold table: %zu reachable functions, longest folded sequence %zu (MAX_FOLDED_LENGTH %zu)\n",
+        table.sequences.size(), table.longest, MAX_FOLDED_LENGTH);
+
+    bool ok = true;
+    if (table.overflowed) {
+        std::printf("MAX_FOLDED_LENGTH is too small for the operation model\n");
+        ok = false;
+    }
+    if (ok && !CheckEveryFold()) ok = false;
+    if (ok && !CheckUncreatedView()) ok = false;
+
+    size_t checked = 0;
+    if (ok && !CheckAllSequences(maxLength, checked)) ok = false;
+    if (ok) std::printf("every fold exact, %zu sequences up to length %zu reduce correctly\n", checked, maxLength);
+
+    return ok ? 0 : 1;
+}
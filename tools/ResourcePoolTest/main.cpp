@@ -0,0 +1,138 @@
+﻿// ResourcePoolTest: checks ResourcePool reuse, LRU eviction and trimming with plain values.
+//
+//   ResourcePoolTest
+//
+// Prints every failed check and exits with 1 if there was one.
+
+#include <Utils/ResourcePool.h>
+
+#include <cstdio>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            failures++; \
+        } \
+    } while (false)
+
+using Pool = ResourcePool<int, int>;
+
+static void TestReuse() {
+    std::vector<int> released;
+    Pool pool(100, [&](int& resource) { released.push_back(resource); });
+
+    CHECK(!pool.acquire(1).has_value());
+
+    pool.release(1, 10, 10);
+    pool.release(1, 11, 10);
+    pool.release(2, 20, 10);
+    CHECK(pool.get_stats().pooledCount == 3);
+    CHECK(pool.get_stats().pooledBytes == 30);
+
+    // Exact key only, most recently returned first.
+    CHECK(pool.acquire(1) == 11);
+    CHECK(pool.acquire(1) == 10);
+    CHECK(!pool.acquire(1).has_value());
+    CHECK(!pool.acquire(3).has_value());
+    CHECK(pool.acquire(2) == 20);
+
+    auto stats = pool.get_stats();
+    CHECK(stats.hits == 3);
+    CHECK(stats.misses == 3);
+    CHECK(stats.evictions == 0);
+    CHECK(stats.pooledCount == 0);
+    CHECK(stats.pooledBytes == 0);
+    CHECK(released.empty());
+}
+
+static void TestCapacityEvictsLeastRecentlyReturned() {
+    std::vector<int> released;
+    Pool pool(30, [&](int& resource) { released.push_back(resource); });
+
+    pool.release(1, 10, 10);
+    pool.release(2, 20, 10);
+    pool.release(1, 11, 10);
+    CHECK(released.empty());
+
+    // Over capacity: the oldest entry of any bucket goes first.
+    pool.release(3, 30, 10);
+    CHECK(released == std::vector<int>{ 10 });
+    pool.release(3, 31, 20);
+    CHECK((released == std::vector<int>{ 10, 20, 11 }));
+
+    auto stats = pool.get_stats();
+    CHECK(stats.evictions == 3);
+    CHECK(stats.pooledBytes == 30);
+    CHECK(stats.pooledCount == 2);
+    CHECK(pool.acquire(3) == 31);
+    CHECK(pool.acquire(3) == 30);
+}
+
+static void TestOversizedResourceIsNotPooled() {
+    std::vector<int> released;
+    Pool pool(10, [&](int& resource) { released.push_back(resource); });
+
+    pool.release(1, 10, 11);
+    CHECK(released == std::vector<int>{ 10 });
+    CHECK(pool.get_stats().pooledCount == 0);
+    CHECK(pool.get_stats().evictions == 1);
+    CHECK(!pool.acquire(1).has_value());
+}
+
+static void TestTrimAndCapacity() {
+    std::vector<int> released;
+    Pool pool(100, [&](int& resource) { released.push_back(resource); });
+
+    for (int i = 0; i < 5; i++) pool.release(i % 2, i, 10);
+
+    pool.trim(30);
+    CHECK((released == std::vector<int>{ 0, 1 }));
+    CHECK(pool.get_stats().pooledBytes == 30);
+
+    // Buckets stay consistent after trimming from their front.
+    CHECK(pool.acquire(0) == 4);
+    CHECK(pool.acquire(0) == 2);
+    CHECK(!pool.acquire(0).has_value());
+
+    pool.set_capacity(0);
+    CHECK(pool.capacity() == 0);
+    CHECK((released == std::vector<int>{ 0, 1, 3 }));
+    CHECK(pool.get_stats().pooledCount == 0);
+
+    pool.set_capacity(100);
+    pool.release(5, 50, 10);
+    pool.clear();
+    CHECK(released.back() == 50);
+    CHECK(pool.get_stats().pooledBytes == 0);
+}
+
+static void TestDestructorReleasesPooled() {
+    std::vector<int> released;
+    {
+        Pool pool(100, [&](int& resource) { released.push_back(resource); });
+        pool.release(1, 10, 10);
+        pool.release(2, 20, 10);
+        CHECK(pool.acquire(2) == 20);
+    }
+    CHECK(released == std::vector<int>{ 10 });
+}
+
+int main()
+{
+    TestReuse();
+    TestCapacityEvictsLeastRecentlyReturned();
+    TestOversizedResourceIsNotPooled();
+    TestTrimAndCapacity();
+    TestDestructorReleasesPooled();
+
+    if (failures > 0) {
+        std::printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("all ResourcePool checks passed\n");
+    return 0;
+}
@@ -40,3 +40,43 @@ target("PrismaUI")
     add_linkdirs(ULTRALIGHT_LIBRARY_DIR)
     
     add_links("UltralightCore", "AppCore", "Ultralight", "WebCore")
+
+-- builds .prismapack archives served by PrismaUI's PackFileSystem
+target("PrismaPack")
+    set_kind("binary")
+    set_default(false)
+
+    add_files("tools/PrismaPack/*.cpp")
+    add_includedirs("src")
+
+-- exhaustive check of the view operation fold table, exits non-zero on a mismatch
+target("ReducerCheck")
+    set_kind("binary")
+    set_default(false)
+
+    add_files("tools/ReducerCheck/*.cpp")
+    add_includedirs("src")
+
+-- reuse, eviction and trimming checks for Utils/ResourcePool.h, exits non-zero on a failure
+target("ResourcePoolTest")
+    set_kind("binary")
+    set_default(false)
+
+    add_files("tools/ResourcePoolTest/*.cpp")
+    add_includedirs("src")
+
+-- per-call cost of the deferred hot-path logger
+target("DeferredLogBench")
+    set_kind("binary")
+    set_default(false)
+
+    add_files("tools/DeferredLogBench/*.cpp", "src/Utils/DeferredLog/DeferredLog.cpp")
+    add_includedirs("src")
+
+-- per-frame view bookkeeping in D3DPresent: map scans, view snapshot and frame table
+target("PresentBench")
+    set_kind("binary")
+    set_default(false)
+
+    add_files("tools/PresentBench/*.cpp")
+    add_includedirs("src")